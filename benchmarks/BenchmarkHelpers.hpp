@@ -0,0 +1,123 @@
+#ifndef BENCHMARKHELPERS_HPP
+#define BENCHMARKHELPERS_HPP
+
+/**************************************************************************
+ * Helpers shared by the benchmark executables. Results are printed as
+ * comma separated values with a header line, so that runs can be saved
+ * and compared to find regressions.
+**************************************************************************/
+
+#include "ColorProfile.hpp"
+
+#include <stdint.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// every benchmark uses the same seed, so that every run draws the same things
+constexpr uint32_t BENCHMARK_SEED = 12345;
+
+inline const char* benchmarkFormatName (CP_FORMAT format)
+{
+	switch ( format )
+	{
+		case CP_FORMAT::MONOCHROME_1BIT:
+			return "MONOCHROME_1BIT";
+		case CP_FORMAT::RGB_24BIT:
+			return "RGB_24BIT";
+		case CP_FORMAT::BGR_24BIT:
+			return "BGR_24BIT";
+		case CP_FORMAT::RGBA_32BIT:
+			return "RGBA_32BIT";
+		default:
+			return "UNKNOWN";
+	}
+}
+
+// a font with a glyph for every printable ascii character, in the format the Font class reads. The glyphs are random, since only
+// the number of pixels that are on matters for benchmarking
+inline std::vector<uint8_t> makeBenchmarkFont (uint8_t characterWidth = 8, uint8_t characterHeight = 8)
+{
+	constexpr char firstCharacter = ' ';
+	constexpr char lastCharacter = '~';
+	constexpr unsigned int numCharacters = lastCharacter - firstCharacter + 1;
+	constexpr unsigned int mappingStartIndex = 7;
+	constexpr unsigned int bitmapStartIndex = mappingStartIndex + ( numCharacters * 2 );
+	static_assert( bitmapStartIndex <= 255, "the bitmap start index has to fit in a byte" );
+
+	const uint32_t bitmapWidth = numCharacters * characterWidth;
+	std::vector<uint8_t> data = {
+		characterWidth,
+		static_cast<uint8_t>( bitmapWidth >> 24 ), static_cast<uint8_t>( bitmapWidth >> 16 ),
+		static_cast<uint8_t>( bitmapWidth >> 8 ),  static_cast<uint8_t>( bitmapWidth ),
+		characterHeight,
+		static_cast<uint8_t>( bitmapStartIndex )
+	};
+
+	for ( unsigned int characterNum = 0; characterNum < numCharacters; characterNum++ )
+	{
+		data.push_back( static_cast<uint8_t>(firstCharacter + characterNum) );
+		data.push_back( static_cast<uint8_t>(characterNum) );
+	}
+
+	std::mt19937 random( BENCHMARK_SEED );
+	const unsigned int bitmapSizeInBytes = ( (bitmapWidth * characterHeight) + 7 ) / 8;
+	for ( unsigned int byteNum = 0; byteNum < bitmapSizeInBytes; byteNum++ )
+	{
+		data.push_back( static_cast<uint8_t>(random()) );
+	}
+
+	return data;
+}
+
+struct BenchmarkResult
+{
+	uint64_t 	calls = 0;
+	double 		nanoseconds = 0.0;
+	double 		pixels = 0.0;
+
+	double getNanosecondsPerCall() const { return ( calls == 0 ) ? 0.0 : nanoseconds / static_cast<double>( calls ); }
+	double getMegapixelsPerSecond() const { return ( nanoseconds == 0.0 ) ? 0.0 : ( pixels / nanoseconds ) * 1000.0; }
+};
+
+// calls func with the call number until minDuration has passed, func returns the number of pixels it drew
+template <typename Func>
+BenchmarkResult runBenchmark (Func&& func, std::chrono::milliseconds minDuration)
+{
+	// the clock is only checked every few calls, so that reading it doesn't show up in the times of cheap calls
+	constexpr uint64_t callsPerClockCheck = 16;
+
+	BenchmarkResult result;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point now = start;
+	while ( now - start < minDuration )
+	{
+		for ( uint64_t callNum = 0; callNum < callsPerClockCheck; callNum++ )
+		{
+			result.pixels += func( result.calls );
+			result.calls++;
+		}
+
+		now = std::chrono::steady_clock::now();
+	}
+	result.nanoseconds = std::chrono::duration<double, std::nano>( now - start ).count();
+
+	return result;
+}
+
+inline void printBenchmarkHeader()
+{
+	std::printf( "benchmark,format,width,height,threads,name,calls,ns_per_call,mpixels_per_s\n" );
+}
+
+inline void printBenchmarkResult (const char* benchmark, CP_FORMAT format, unsigned int width, unsigned int height,
+					unsigned int numThreads, const std::string& name, const BenchmarkResult& result)
+{
+	std::printf( "%s,%s,%u,%u,%u,%s,%llu,%.1f,%.3f\n", benchmark, benchmarkFormatName(format), width, height, numThreads, name.c_str(),
+			static_cast<unsigned long long>(result.calls), result.getNanosecondsPerCall(), result.getMegapixelsPerSecond() );
+	std::fflush( stdout );
+}
+
+#endif // BENCHMARKHELPERS_HPP
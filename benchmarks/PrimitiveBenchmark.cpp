@@ -0,0 +1,416 @@
+/**************************************************************************
+ * Measures each drawing primitive of the software renderer for every
+ * CP_FORMAT at a few resolutions, drawing through a SurfaceSingleCore.
+ * The pixel counts used for Mpixels/s are the pixels each call covers
+ * before clipping, except for drawTriangleShaded, which counts the
+ * fragment shader calls, and fill, which is timed as a whole frame
+ * since fills are only applied at the end of the frame. Build the prim
+ * target from the repository root, which defines NO_GPU:
+ *
+ * cmake -S . -B build && cmake --build build --target prim
+ *
+ * The prim-fixed target defines FIXED_POINT_RASTERIZATION as well, and
+ * its triangle rasterizer rows end in _fixed_point, so both builds can
+ * be compared.
+ * Either build then checks that fixed point edge walking covers the
+ * same pixels as float edge walking, and that advancing an edge past
+ * rows covers the same pixels as stepping through them, and the exit
+ * code is 1 if not.
+ *
+ * Usage: prim [milliseconds per primitive, 200 default]
+**************************************************************************/
+
+#include "Surface.hpp"
+#include "Engine3D.hpp"
+#include "BenchmarkHelpers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr unsigned int BENCHMARK_SHADER_PASS_DATA_SIZE = 4;
+constexpr unsigned int NUM_PREGENERATED = 256;
+constexpr unsigned int SPRITE_SIZE = 32;
+constexpr unsigned int NUM_TEXT_CHARACTERS = 20;
+constexpr unsigned int NUM_POLYLINE_POINTS = 16;
+constexpr unsigned int NUM_COVERAGE_TRIANGLES = 1000;
+
+// the triangle rasterizer rows are named after the edge walking they were built with
+#ifdef FIXED_POINT_RASTERIZATION
+constexpr const char* RASTERIZATION_SUFFIX = "_fixed_point";
+#else
+constexpr const char* RASTERIZATION_SUFFIX = "";
+#endif
+
+static uint64_t shadedPixels = 0;
+
+template <CP_FORMAT format, RENDER_API api, unsigned int shaderPassDataSize>
+static void benchmarkVShader (TriShaderData<format, api, shaderPassDataSize>& /*vShaderData*/)
+{
+}
+
+template <CP_FORMAT format, RENDER_API api, unsigned int shaderPassDataSize>
+static void benchmarkFShader (Color& colorOut, TriShaderData<format, api, shaderPassDataSize>& fShaderData, float /*v1Cur*/,
+				float /*v2Cur*/, float /*v3Cur*/, float /*texCoordX*/, float /*texCoordY*/, float lightAmnt)
+{
+	shadedPixels++;
+	colorOut = fShaderData.color * lightAmnt;
+	colorOut.m_A = 1.0f;
+	colorOut.m_M = true;
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format>
+class PrimitiveBenchmarkSurface : public SurfaceSingleCore<RENDER_API::SOFTWARE, width, height, format, true, BENCHMARK_SHADER_PASS_DATA_SIZE>
+{
+	public:
+		using GraphicsType = Graphics<width, height, format, RENDER_API::SOFTWARE, true, BENCHMARK_SHADER_PASS_DATA_SIZE>;
+
+		PrimitiveBenchmarkSurface (std::chrono::milliseconds minDuration) :
+			m_MinDuration( minDuration ),
+			m_FontData( makeBenchmarkFont() ),
+			m_Font( m_FontData.data() ),
+			m_Sprite( SPRITE_SIZE, SPRITE_SIZE ),
+			m_Textures{ nullptr },
+			m_Camera( 0.1f, 100.0f, 90.0f, static_cast<float>(height) / static_cast<float>(width) ),
+			m_Random( BENCHMARK_SEED )
+		{
+			for ( uint8_t& byte : m_Sprite.getTexture().getPixels() )
+			{
+				byte = static_cast<uint8_t>( m_Random() );
+			}
+
+			std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+			for ( unsigned int pointNum = 0; pointNum < NUM_PREGENERATED; pointNum++ )
+			{
+				m_Points[pointNum] = { unit(m_Random), unit(m_Random) };
+			}
+
+			// faces parallel to the screen at the same depth, so that every pixel passes the depth test each time
+			std::uniform_real_distribution<float> position( -2.0f, 1.0f );
+			std::uniform_real_distribution<float> size( 0.2f, 1.0f );
+			for ( Face& face : m_Faces )
+			{
+				const float x = position( m_Random );
+				const float y = position( m_Random );
+				const float faceSize = size( m_Random );
+				const float z = 3.0f;
+				face = Face{{
+					{ {{x, y, z, 1.0f}},                       {{0.0f, 0.0f, -1.0f, 0.0f}}, {{0.0f, 0.0f}} },
+					{ {{x, y + faceSize, z, 1.0f}},            {{0.0f, 0.0f, -1.0f, 0.0f}}, {{0.0f, 1.0f}} },
+					{ {{x + faceSize, y + faceSize, z, 1.0f}}, {{0.0f, 0.0f, -1.0f, 0.0f}}, {{1.0f, 1.0f}} }
+				}};
+			}
+		}
+
+		void draw (GraphicsType* graphics) override
+		{
+			// the graphics objects may be placed in memory after construction, so the font is set here
+			graphics->setFont( &m_Font );
+			graphics->setColor( 0.8f, 0.4f, 0.2f );
+
+			if ( m_FillOnly )
+			{
+				graphics->fill();
+				return;
+			}
+
+			this->run( "drawLine", [&](uint64_t callNum)
+				{
+					const Point& start = this->getPoint( callNum * 2 );
+					const Point& end = this->getPoint( (callNum * 2) + 1 );
+					graphics->drawLine( start.x, start.y, end.x, end.y );
+					return std::max( std::abs(end.x - start.x) * (width - 1), std::abs(end.y - start.y) * (height - 1) ) + 1.0;
+				} );
+
+			this->run( "drawPolyline", [&](uint64_t callNum)
+				{
+					std::array<float, (NUM_POLYLINE_POINTS * 2)> points;
+					double pixels = 0.0;
+					for ( unsigned int pointNum = 0; pointNum < NUM_POLYLINE_POINTS; pointNum++ )
+					{
+						const Point& point = this->getPoint( (callNum * NUM_POLYLINE_POINTS) + pointNum );
+						points[(pointNum * 2)] = point.x;
+						points[(pointNum * 2) + 1] = point.y;
+						if ( pointNum > 0 )
+						{
+							pixels += std::max( std::abs(point.x - points[(pointNum * 2) - 2]) * (width - 1),
+									std::abs(point.y - points[(pointNum * 2) - 1]) * (height - 1) );
+						}
+					}
+					graphics->drawPolyline( points.data(), NUM_POLYLINE_POINTS );
+					return pixels + 1.0;
+				} );
+
+			this->run( "drawBoxFilled", [&](uint64_t callNum)
+				{
+					const Point& start = this->getPoint( callNum * 2 );
+					const Point& end = this->getPoint( (callNum * 2) + 1 );
+					graphics->drawBoxFilled( start.x, start.y, end.x, end.y );
+					return std::abs( (end.x - start.x) * (width - 1) ) * std::abs( (end.y - start.y) * (height - 1) );
+				} );
+
+			this->run( std::string("drawTriangleFilled") + RASTERIZATION_SUFFIX, [&](uint64_t callNum)
+				{
+					const Point& p1 = this->getPoint( callNum * 3 );
+					const Point& p2 = this->getPoint( (callNum * 3) + 1 );
+					const Point& p3 = this->getPoint( (callNum * 3) + 2 );
+					graphics->drawTriangleFilled( p1.x, p1.y, p2.x, p2.y, p3.x, p3.y );
+					return std::abs( ((p2.x - p1.x) * (p3.y - p1.y)) - ((p3.x - p1.x) * (p2.y - p1.y)) ) * 0.5
+						* (width - 1) * (height - 1);
+				} );
+
+			this->run( "drawCircleFilled", [&](uint64_t callNum)
+				{
+					const Point& origin = this->getPoint( callNum );
+					const float radius = this->getPoint( callNum + 1 ).x * 0.25f;
+					graphics->drawCircleFilled( origin.x, origin.y, radius );
+					const double radiusInPixels = radius * (width - 1);
+					return M_PI * radiusInPixels * radiusInPixels;
+				} );
+
+			const std::string text = "The quick brown fox!";
+			static_assert( NUM_TEXT_CHARACTERS == 20, "text has to be NUM_TEXT_CHARACTERS long" );
+			this->run( "drawText", [&](uint64_t callNum)
+				{
+					const Point& start = this->getPoint( callNum );
+					graphics->drawText( start.x * 0.5f, start.y * 0.9f, text.c_str(), 1.0f );
+					return static_cast<double>( NUM_TEXT_CHARACTERS * m_Font.getCharacterWidth() * m_Font.getBitmapHeight() );
+				} );
+			// the same text every call, so it's only rendered into the text cache once
+			this->run( "drawTextCached", [&](uint64_t callNum)
+				{
+					const Point& start = this->getPoint( callNum );
+					graphics->drawTextCached( start.x * 0.5f, start.y * 0.9f, text.c_str(), 1.0f );
+					return static_cast<double>( NUM_TEXT_CHARACTERS * m_Font.getCharacterWidth() * m_Font.getBitmapHeight() );
+				} );
+
+			const float spriteMaxX = 1.0f - ( static_cast<float>(SPRITE_SIZE) / width );
+			const float spriteMaxY = 1.0f - ( static_cast<float>(SPRITE_SIZE) / height );
+			this->run( "drawSprite", [&](uint64_t callNum)
+				{
+					const Point& start = this->getPoint( callNum );
+					graphics->drawSprite( start.x * spriteMaxX, start.y * spriteMaxY, m_Sprite );
+					return static_cast<double>( SPRITE_SIZE * SPRITE_SIZE );
+				} );
+
+			TriShaderData<format, RENDER_API::SOFTWARE, BENCHMARK_SHADER_PASS_DATA_SIZE> shaderData{ m_Textures, m_Camera,
+				Color{ 0.2f, 0.6f, 0.9f, 1.0f, true }, nullptr,
+				benchmarkVShader<format, RENDER_API::SOFTWARE, BENCHMARK_SHADER_PASS_DATA_SIZE>,
+				benchmarkFShader<format, RENDER_API::SOFTWARE, BENCHMARK_SHADER_PASS_DATA_SIZE> };
+			this->run( std::string("drawTriangleShaded") + RASTERIZATION_SUFFIX, [&](uint64_t callNum)
+				{
+					// the face is transformed in place, so each call gets a copy
+					Face face = m_Faces[callNum % m_Faces.size()];
+					const uint64_t shadedPixelsBefore = shadedPixels;
+					graphics->drawTriangleShaded( face, shaderData );
+					return static_cast<double>( shadedPixels - shadedPixelsBefore );
+				} );
+		}
+
+		// the fill is only applied to the frame buffer at the end of the frame, so each call renders a whole frame that just fills
+		void runFillBenchmark()
+		{
+			m_FillOnly = true;
+			this->run( "fill", [&](uint64_t /*callNum*/)
+				{
+					this->render();
+					return static_cast<double>( width * height );
+				} );
+			m_FillOnly = false;
+		}
+
+	private:
+		struct Point
+		{
+			float x;
+			float y;
+		};
+
+		std::chrono::milliseconds 					m_MinDuration;
+		std::vector<uint8_t> 						m_FontData;
+		Font 								m_Font;
+		Sprite<format, RENDER_API::SOFTWARE> 				m_Sprite;
+		std::array<Texture<format, RENDER_API::SOFTWARE>*, 5> 		m_Textures;
+		Camera3D 							m_Camera;
+		std::mt19937 							m_Random;
+		std::array<Point, NUM_PREGENERATED> 				m_Points;
+		std::array<Face, 32> 						m_Faces;
+		bool 								m_FillOnly = false;
+
+		const Point& getPoint (uint64_t pointNum) const { return m_Points[pointNum % NUM_PREGENERATED]; }
+
+		template <typename Func>
+		void run (const std::string& name, Func&& func)
+		{
+			printBenchmarkResult( "primitive", format, width, height, 1, name, runBenchmark(func, m_MinDuration) );
+		}
+};
+
+template <unsigned int width, unsigned int height, CP_FORMAT format>
+static void runPrimitiveBenchmark (std::chrono::milliseconds minDuration)
+{
+	using SurfaceType = PrimitiveBenchmarkSurface<width, height, format>;
+
+	// the frame buffers are too big for the stack
+	std::vector<uint8_t> graphicsMemory( (sizeof(typename SurfaceType::GraphicsType) * 2) + 1 );
+	std::unique_ptr<SurfaceType> surface = std::make_unique<SurfaceType>( minDuration );
+#ifdef NO_GPU
+	surface->placeGraphicsObjectsInMemory( graphicsMemory.data(), graphicsMemory.size() );
+#endif
+
+	surface->runFillBenchmark();
+	surface->render();
+}
+
+// adds one to the coverage of each pixel the triangle covers with the given edge walking, with the vertices in pixels. The edges are
+// advanced past the rows above firstRow, like the rasterizers do for the rows above the scissor rect
+template <typename Edge>
+static void addTriangleCoverage (std::vector<uint8_t>& coverage, unsigned int width, unsigned int height, const std::array<float, 6>& vertices,
+					int firstRow)
+{
+	walkTriangleEdges<Edge>( vertices[0], vertices[1], vertices[2], vertices[3], vertices[4], vertices[5],
+		[&](int startRow, int endRowExclusive, Edge& leftEdge, Edge& rightEdge)
+		{
+			const int walkStartRow = std::min( std::max(startRow, firstRow), endRowExclusive );
+			leftEdge.advance( walkStartRow - startRow );
+			rightEdge.advance( walkStartRow - startRow );
+
+			for ( int row = walkStartRow; row < endRowExclusive; row++ )
+			{
+				if ( row < static_cast<int>(height) )
+				{
+					const int colEnd = std::min( rightEdge.x(), static_cast<int>(width) );
+					for ( int col = std::max(leftEdge.x(), 0); col < colEnd; col++ )
+					{
+						coverage[(row * width) + col]++;
+					}
+				}
+
+				leftEdge.step();
+				rightEdge.step();
+			}
+		} );
+}
+
+// the horizontal distance in pixels from a pixel center to the closest edge of the triangle that crosses its row
+static double distanceToTriangleEdge (const std::array<float, 6>& vertices, int col, int row)
+{
+	double distance = std::numeric_limits<double>::max();
+	for ( unsigned int edgeNum = 0; edgeNum < 3; edgeNum++ )
+	{
+		const double xStart = vertices[(edgeNum * 2)];
+		const double yStart = vertices[(edgeNum * 2) + 1];
+		const double xEnd = vertices[(((edgeNum + 1) % 3) * 2)];
+		const double yEnd = vertices[(((edgeNum + 1) % 3) * 2) + 1];
+		if ( yStart == yEnd || row < std::min(yStart, yEnd) || row > std::max(yStart, yEnd) ) continue;
+
+		const double edgeX = xStart + ( (row - yStart) * (xEnd - xStart) / (yEnd - yStart) );
+		distance = std::min( distance, std::abs(edgeX - col) );
+	}
+
+	return distance;
+}
+
+// with the vertices on the fixed point grid both edge walkings should cover the same pixels. Float edge walking rounds the edge
+// positions though, so pixels whose centers are closer than a subpixel to an edge are allowed to differ, and no others. Advancing
+// either edge walking past the top half of the screen has to cover the bottom half exactly like stepping through the top half does
+template <unsigned int width, unsigned int height>
+static bool checkFixedPointCoverage()
+{
+	constexpr float subpixelOne = FixedPointEdge::SUBPIXEL_ONE;
+	constexpr unsigned int advancedFirstRow = height / 2;
+
+	std::mt19937 random( BENCHMARK_SEED );
+	std::uniform_real_distribution<float> position( -0.25f, 1.25f );
+	std::vector<uint8_t> floatCoverage( width * height );
+	std::vector<uint8_t> fixedPointCoverage( width * height );
+	std::vector<uint8_t> advancedFloatCoverage( width * height );
+	std::vector<uint8_t> advancedFixedPointCoverage( width * height );
+	uint64_t numCoveredPixels = 0;
+	uint64_t numRoundedPixels = 0;
+	uint64_t numDifferentPixels = 0;
+	uint64_t numAdvancedPixels = 0;
+	uint64_t numAdvancedDifferentPixels = 0;
+	for ( unsigned int triangleNum = 0; triangleNum < NUM_COVERAGE_TRIANGLES; triangleNum++ )
+	{
+		std::array<float, 6> vertices;
+		for ( unsigned int coordNum = 0; coordNum < vertices.size(); coordNum++ )
+		{
+			const float size = ( coordNum % 2 == 0 ) ? width - 1 : height - 1;
+			vertices[coordNum] = std::round( position(random) * size * subpixelOne ) / subpixelOne;
+		}
+		triSortVertices( vertices[0], vertices[1], vertices[2], vertices[3], vertices[4], vertices[5] );
+
+		std::fill( floatCoverage.begin(), floatCoverage.end(), 0 );
+		std::fill( fixedPointCoverage.begin(), fixedPointCoverage.end(), 0 );
+		std::fill( advancedFloatCoverage.begin(), advancedFloatCoverage.end(), 0 );
+		std::fill( advancedFixedPointCoverage.begin(), advancedFixedPointCoverage.end(), 0 );
+		addTriangleCoverage<FloatEdge>( floatCoverage, width, height, vertices, 0 );
+		addTriangleCoverage<FixedPointEdge>( fixedPointCoverage, width, height, vertices, 0 );
+		addTriangleCoverage<FloatEdge>( advancedFloatCoverage, width, height, vertices, advancedFirstRow );
+		addTriangleCoverage<FixedPointEdge>( advancedFixedPointCoverage, width, height, vertices, advancedFirstRow );
+
+		for ( unsigned int pixelNum = advancedFirstRow * width; pixelNum < width * height; pixelNum++ )
+		{
+			numAdvancedPixels += floatCoverage[pixelNum] + fixedPointCoverage[pixelNum];
+			numAdvancedDifferentPixels += ( advancedFloatCoverage[pixelNum] != floatCoverage[pixelNum] )
+							+ ( advancedFixedPointCoverage[pixelNum] != fixedPointCoverage[pixelNum] );
+		}
+
+		for ( unsigned int pixelNum = 0; pixelNum < width * height; pixelNum++ )
+		{
+			numCoveredPixels += fixedPointCoverage[pixelNum];
+			if ( floatCoverage[pixelNum] == fixedPointCoverage[pixelNum] ) continue;
+
+			if ( distanceToTriangleEdge(vertices, pixelNum % width, pixelNum / width) < 1.0 / subpixelOne )
+			{
+				numRoundedPixels++;
+			}
+			else
+			{
+				numDifferentPixels++;
+			}
+		}
+	}
+
+	std::printf( "coverage,%u,%u,fixed_point_vs_float,%u,%llu,%llu,%llu\n", width, height, NUM_COVERAGE_TRIANGLES,
+			static_cast<unsigned long long>(numCoveredPixels), static_cast<unsigned long long>(numRoundedPixels),
+			static_cast<unsigned long long>(numDifferentPixels) );
+	std::printf( "coverage,%u,%u,advance_vs_step,%u,%llu,0,%llu\n", width, height, NUM_COVERAGE_TRIANGLES,
+			static_cast<unsigned long long>(numAdvancedPixels), static_cast<unsigned long long>(numAdvancedDifferentPixels) );
+	std::fflush( stdout );
+
+	return numDifferentPixels == 0 && numAdvancedDifferentPixels == 0;
+}
+
+template <unsigned int width, unsigned int height>
+static void runPrimitiveBenchmarks (std::chrono::milliseconds minDuration)
+{
+	runPrimitiveBenchmark<width, height, CP_FORMAT::MONOCHROME_1BIT>( minDuration );
+	runPrimitiveBenchmark<width, height, CP_FORMAT::RGB_24BIT>( minDuration );
+	runPrimitiveBenchmark<width, height, CP_FORMAT::BGR_24BIT>( minDuration );
+	runPrimitiveBenchmark<width, height, CP_FORMAT::RGBA_32BIT>( minDuration );
+}
+
+int main (int argc, char* argv[])
+{
+	const std::chrono::milliseconds minDuration( (argc > 1) ? std::atoi(argv[1]) : 200 );
+
+	printBenchmarkHeader();
+	runPrimitiveBenchmarks<128, 64>( minDuration );
+	runPrimitiveBenchmarks<320, 240>( minDuration );
+	runPrimitiveBenchmarks<640, 480>( minDuration );
+
+	std::printf( "check,width,height,name,triangles,pixels,rounded_pixels,different_pixels\n" );
+	bool coverageMatches = checkFixedPointCoverage<128, 64>();
+	coverageMatches = checkFixedPointCoverage<320, 240>() && coverageMatches;
+	coverageMatches = checkFixedPointCoverage<640, 480>() && coverageMatches;
+
+	return coverageMatches ? 0 : 1;
+}
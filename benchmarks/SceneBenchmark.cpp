@@ -0,0 +1,1061 @@
+/**************************************************************************
+ * Renders a few representative scenes through Surface::render() and
+ * advanceFrameBuffer() for every number of render threads from 1 to
+ * SCENE_MAX_RENDER_THREADS, and reports the frames per second of each.
+ * Every frame of a scene is drawn with the same seed, so the last frame
+ * is compared against a golden image to check that optimizations don't
+ * change what is drawn. The dashboard is also replayed from a recorded
+ * DisplayList, and the model is also drawn in tiled mode and with a
+ * depth pre-pass, and these are compared against the golden image of
+ * the scene they draw. The scene graph moves a sprite every frame and
+ * only redraws what changed, so instead each frame it returns for a
+ * while after timing is compared against a full redraw of that frame,
+ * and the pixels that changed since the frame before have to be inside
+ * of the surface's damage. damage_per_frame is the average area of the
+ * surface's damage over the timed frames, in pixels. If
+ * PERSPECTIVE_SUBDIVISION is defined, the tex coords of a receding wall
+ * are also checked against the error bound of perspective subdivision,
+ * and the model is compared against a golden image of its own for that
+ * subdivision length. Build the scene target from the repository root,
+ * which defines NO_GPU:
+ *
+ * cmake -S . -B build && cmake --build build --target scene
+ *
+ * The scene-subdiv target defines PERSPECTIVE_SUBDIVISION=16.
+ *
+ * Usage: scene [--frames n] [--tolerance n] [--update-golden]
+ *	[--assets directory] [--golden directory]
+ *
+ * Run from the repository root, or give the assets and golden
+ * directories. --update-golden writes the golden images instead of
+ * comparing against them. --tolerance is the largest difference a color
+ * channel may have from the golden image, 0 by default. --frames is at
+ * least SCENE_MIN_FRAMES, so that every buffer holds a frame when the
+ * last one is compared. The exit code is 1 if any frame doesn't match
+ * its golden image, or if a tex coord is outside of the error bound.
+**************************************************************************/
+
+#include "Surface.hpp"
+#include "Engine3D.hpp"
+#include "DisplayList.hpp"
+#include "ObjFileLoader.hpp"
+#include "SceneGraph.hpp"
+#include "BenchmarkHelpers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr unsigned int SCENE_WIDTH = 160;
+constexpr unsigned int SCENE_HEIGHT = 120;
+constexpr CP_FORMAT SCENE_FORMAT = CP_FORMAT::RGB_24BIT;
+constexpr unsigned int SCENE_SHADER_PASS_DATA_SIZE = 4;
+constexpr unsigned int SCENE_MAX_RENDER_THREADS = 4;
+// a threaded surface renders to each of its buffers in turn, and a single core surface renders its first two frames to the same
+// buffer, so with fewer frames the compared buffer would never have been rendered to
+constexpr unsigned int SCENE_MIN_FRAMES = std::max( SCENE_MAX_RENDER_THREADS, 3u );
+constexpr unsigned int SCENE_NUM_SPRITES = 8;
+constexpr unsigned int SCENE_GRAPH_PATH_FRAMES = 48;
+// after the timed frames, the scene graph is checked against a full redraw for this many more frames
+constexpr unsigned int SCENE_GRAPH_CHECK_FRAMES = SCENE_GRAPH_PATH_FRAMES;
+
+enum class SCENE
+{
+	DASHBOARD,
+	DASHBOARD_DISPLAY_LIST,
+	OBJ_MODEL,
+	OBJ_MODEL_TILED,
+	OBJ_MODEL_DEPTH_PRE_PASS,
+	SPRITE_STORM,
+	TEXT_PAGE,
+	SCENE_GRAPH
+};
+
+static const char* sceneName (SCENE scene)
+{
+	switch ( scene )
+	{
+		case SCENE::DASHBOARD:
+			return "dashboard";
+		case SCENE::DASHBOARD_DISPLAY_LIST:
+			return "dashboard_display_list";
+		case SCENE::OBJ_MODEL:
+			return "obj_model";
+		case SCENE::OBJ_MODEL_TILED:
+			return "obj_model_tiled";
+		case SCENE::OBJ_MODEL_DEPTH_PRE_PASS:
+			return "obj_model_depth_pre_pass";
+		case SCENE::SPRITE_STORM:
+			return "sprite_storm";
+		case SCENE::TEXT_PAGE:
+			return "text_page";
+		case SCENE::SCENE_GRAPH:
+			return "scene_graph";
+		default:
+			return "unknown";
+	}
+}
+
+using SceneGraphics = Graphics<SCENE_WIDTH, SCENE_HEIGHT, SCENE_FORMAT, RENDER_API::SOFTWARE, true, SCENE_SHADER_PASS_DATA_SIZE>;
+using SceneFrameBuffer = FrameBufferFixed<SCENE_WIDTH, SCENE_HEIGHT, SCENE_FORMAT, RENDER_API::SOFTWARE>;
+
+// everything the scenes draw with, loaded once and only read while drawing, since render threads draw at the same time
+struct SceneAssets
+{
+	std::vector<uint8_t> 						fontData;
+	std::unique_ptr<Font> 						font;
+	IndexedMesh 							model;
+	std::unique_ptr<Texture<SCENE_FORMAT, RENDER_API::SOFTWARE>> 	modelTexture;
+	std::vector<std::unique_ptr<Sprite<CP_FORMAT::RGBA_32BIT, RENDER_API::SOFTWARE>>> sprites;
+	DisplayList<RENDER_API::SOFTWARE> 				dashboardDisplayList;
+};
+
+template <typename GraphicsType>
+static void drawDashboard (GraphicsType* graphics, SceneAssets& assets);
+
+static bool loadSceneAssets (SceneAssets& assets, const std::string& assetsDirectory)
+{
+	assets.fontData = makeBenchmarkFont( 5, 7 );
+	assets.font = std::make_unique<Font>( assets.fontData.data() );
+
+	ObjFileLoader objFileLoader;
+	if ( ! objFileLoader.createIndexedMeshFromFile(assets.model, assetsDirectory + "/torus.obj") )
+	{
+		return false;
+	}
+	assets.model.rotate( 60.0f, 20.0f, 0.0f );
+	assets.model.translate( 0.0f, 0.0f, 3.0f );
+
+	// a checkerboard, so that texture mapping mistakes are easy to see in the golden image
+	constexpr unsigned int textureSize = 64;
+	constexpr unsigned int checkerSize = 8;
+	assets.modelTexture = std::make_unique<Texture<SCENE_FORMAT, RENDER_API::SOFTWARE>>( textureSize, textureSize );
+	for ( unsigned int row = 0; row < textureSize; row++ )
+	{
+		for ( unsigned int col = 0; col < textureSize; col++ )
+		{
+			const bool light = ( (row / checkerSize) + (col / checkerSize) ) % 2 == 0;
+			const unsigned int pixelNum = ( (row * textureSize) + col ) * 3;
+			assets.modelTexture->getPixels()[pixelNum + 0] = light ? 230 : 40;
+			assets.modelTexture->getPixels()[pixelNum + 1] = light ? 200 : 60;
+			assets.modelTexture->getPixels()[pixelNum + 2] = light ? 80 : 160;
+		}
+	}
+
+	// round sprites with transparent corners, each with a different color, size, rotation and scale
+	std::mt19937 random( BENCHMARK_SEED );
+	for ( unsigned int spriteNum = 0; spriteNum < SCENE_NUM_SPRITES; spriteNum++ )
+	{
+		const unsigned int spriteSize = 8 + ( spriteNum % 3 ) * 4;
+		auto sprite = std::make_unique<Sprite<CP_FORMAT::RGBA_32BIT, RENDER_API::SOFTWARE>>( spriteSize, spriteSize );
+		const uint8_t red = random() % 256;
+		const uint8_t green = random() % 256;
+		const uint8_t blue = random() % 256;
+		const float center = ( static_cast<float>(spriteSize) - 1.0f ) / 2.0f;
+		for ( unsigned int row = 0; row < spriteSize; row++ )
+		{
+			for ( unsigned int col = 0; col < spriteSize; col++ )
+			{
+				const float distance = std::sqrt( ((row - center) * (row - center)) + ((col - center) * (col - center)) );
+				const float alpha = std::max( 0.0f, 1.0f - (distance / (center + 1.0f)) );
+				const unsigned int pixelNum = ( (row * spriteSize) + col ) * 4;
+				sprite->getTexture().getPixels()[pixelNum + 0] = red;
+				sprite->getTexture().getPixels()[pixelNum + 1] = ( (row + col) % 4 == 0 ) ? 255 : green;
+				sprite->getTexture().getPixels()[pixelNum + 2] = blue;
+				sprite->getTexture().getPixels()[pixelNum + 3] = static_cast<uint8_t>( alpha * 255.0f );
+			}
+		}
+		sprite->setRotationAngle( spriteNum * 25 );
+		sprite->setScaleFactor( 1.0f + (spriteNum % 4) * 0.25f );
+		assets.sprites.push_back( std::move(sprite) );
+	}
+
+	// the dashboard doesn't change between frames, so it's recorded once and replayed every frame
+	drawDashboard( &assets.dashboardDisplayList, assets );
+	assets.dashboardDisplayList.optimize();
+
+	return true;
+}
+
+template <CP_FORMAT format, RENDER_API api, unsigned int shaderPassDataSize>
+static void sceneModelVShader (TriShaderData<format, api, shaderPassDataSize>& /*vShaderData*/)
+{
+}
+
+template <CP_FORMAT format, RENDER_API api, unsigned int shaderPassDataSize>
+static void sceneModelFShader (Color& colorOut, TriShaderData<format, api, shaderPassDataSize>& fShaderData, float /*v1Cur*/,
+				float /*v2Cur*/, float /*v3Cur*/, float texCoordX, float texCoordY, float lightAmnt)
+{
+	colorOut = fShaderData.textures[0]->getColor( texCoordX, texCoordY ) * lightAmnt;
+	colorOut.m_A = 1.0f;
+	colorOut.m_M = true;
+}
+
+// a grid of panels with bar charts, line graphs, gauges and labels
+template <typename GraphicsType>
+static void drawDashboard (GraphicsType* graphics, SceneAssets& /*assets*/)
+{
+	std::mt19937 random( BENCHMARK_SEED );
+	std::uniform_real_distribution<float> unit( 0.0f, 1.0f );
+
+	graphics->setColor( 0.08f, 0.09f, 0.12f );
+	graphics->fill();
+
+	constexpr unsigned int panelCols = 4;
+	constexpr unsigned int panelRows = 3;
+	constexpr float panelWidth = 1.0f / panelCols;
+	constexpr float panelHeight = 1.0f / panelRows;
+	constexpr float margin = 0.01f;
+	for ( unsigned int panelNum = 0; panelNum < panelCols * panelRows; panelNum++ )
+	{
+		const float left = ( panelNum % panelCols ) * panelWidth + margin;
+		const float top = ( panelNum / panelCols ) * panelHeight + margin;
+		const float right = left + panelWidth - ( margin * 2.0f );
+		const float bottom = top + panelHeight - ( margin * 2.0f );
+
+		graphics->setColor( 0.16f, 0.18f, 0.22f );
+		graphics->drawBoxFilled( left, top, right, bottom );
+		graphics->setColor( 0.35f, 0.4f, 0.5f );
+		graphics->drawBox( left, top, right, bottom );
+
+		graphics->setColor( 0.9f, 0.9f, 0.9f );
+		graphics->drawText( left + margin, top + margin, "CH 12.5", 1.0f );
+
+		const float chartTop = top + 0.09f;
+		const float chartHeight = bottom - chartTop - margin;
+		switch ( panelNum % 3 )
+		{
+			case 0: // bar chart
+			{
+				constexpr unsigned int numBars = 8;
+				const float barWidth = ( right - left - (margin * 2.0f) ) / numBars;
+				for ( unsigned int barNum = 0; barNum < numBars; barNum++ )
+				{
+					const float barLeft = left + margin + ( barNum * barWidth );
+					const float value = unit( random );
+					graphics->setColor( 0.2f, 0.5f + (value * 0.5f), 0.9f - (value * 0.5f) );
+					graphics->drawBoxFilled( barLeft, bottom - margin - (chartHeight * value), barLeft + (barWidth * 0.7f), bottom - margin );
+				}
+			}
+				break;
+			case 1: // line graph
+			{
+				constexpr unsigned int numPoints = 32;
+				const float pointSpacing = ( right - left - (margin * 2.0f) ) / ( numPoints - 1 );
+				std::array<float, numPoints * 2> points;
+				for ( unsigned int pointNum = 0; pointNum < numPoints; pointNum++ )
+				{
+					points[(pointNum * 2)] = left + margin + ( pointNum * pointSpacing );
+					points[(pointNum * 2) + 1] = bottom - margin - ( chartHeight * unit(random) );
+				}
+				graphics->setColor( 1.0f, 0.6f, 0.1f );
+				graphics->drawPolyline( points.data(), numPoints );
+			}
+				break;
+			default: // gauge
+			{
+				const float centerX = ( left + right ) / 2.0f;
+				const float centerY = chartTop + ( chartHeight / 2.0f );
+				const float radius = chartHeight * 0.35f;
+				graphics->setColor( 0.3f, 0.8f, 0.4f );
+				graphics->drawCircleFilled( centerX, centerY, radius );
+				graphics->setColor( 0.16f, 0.18f, 0.22f );
+				graphics->drawCircleFilled( centerX, centerY, radius * 0.6f );
+				graphics->setColor( 0.9f, 0.9f, 0.9f );
+				graphics->drawCircle( centerX, centerY, radius );
+				const float angle = unit( random ) * 2.0f * M_PI;
+				graphics->drawLine( centerX, centerY, centerX + (std::cos(angle) * radius * 0.75f),
+							centerY + (std::sin(angle) * radius * 0.75f * SCENE_WIDTH / SCENE_HEIGHT) );
+			}
+				break;
+		}
+	}
+}
+
+// the textured torus from the assets directory, with a label drawn over it after it
+static void drawObjModel (SceneGraphics* graphics, SceneAssets& assets)
+{
+	graphics->setColor( 0.05f, 0.05f, 0.1f );
+	graphics->fill();
+
+	std::array<Texture<SCENE_FORMAT, RENDER_API::SOFTWARE>*, 5> textures = { assets.modelTexture.get(), nullptr, nullptr, nullptr,
+											nullptr };
+	Camera3D camera( 0.1f, 100.0f, 90.0f, static_cast<float>(SCENE_HEIGHT) / static_cast<float>(SCENE_WIDTH) );
+	TriShaderData<SCENE_FORMAT, RENDER_API::SOFTWARE, SCENE_SHADER_PASS_DATA_SIZE> shaderData{ textures, camera, Color(), nullptr,
+		sceneModelVShader<SCENE_FORMAT, RENDER_API::SOFTWARE, SCENE_SHADER_PASS_DATA_SIZE>,
+		sceneModelFShader<SCENE_FORMAT, RENDER_API::SOFTWARE, SCENE_SHADER_PASS_DATA_SIZE> };
+	graphics->drawMesh( assets.model, shaderData );
+
+	// the label has to end up over the model, even when the model's triangles are deferred
+	graphics->setColor( 0.16f, 0.18f, 0.22f );
+	graphics->drawBoxFilled( 0.02f, 0.6f, 0.45f, 0.7f );
+	graphics->setColor( 0.9f, 0.9f, 0.9f );
+	graphics->drawText( 0.04f, 0.62f, "TORUS", 1.0f );
+}
+
+// hundreds of alpha blended, rotated and scaled sprites over a gradient
+static void drawSpriteStorm (SceneGraphics* graphics, SceneAssets& assets)
+{
+	// the boxes leave out the last row and column, and the sprites are blended with whatever was there in the previous frame
+	graphics->setColor( 0.1f, 0.1f, 0.4f );
+	graphics->fill();
+
+	constexpr unsigned int numBands = 16;
+	for ( unsigned int bandNum = 0; bandNum < numBands; bandNum++ )
+	{
+		const float bandFraction = static_cast<float>( bandNum ) / numBands;
+		graphics->setColor( 0.1f, 0.1f + (bandFraction * 0.3f), 0.4f - (bandFraction * 0.3f) );
+		graphics->drawBoxFilled( 0.0f, bandFraction, 1.0f, bandFraction + (1.0f / numBands) );
+	}
+
+	constexpr unsigned int numSprites = 300;
+	std::mt19937 random( BENCHMARK_SEED );
+	std::uniform_real_distribution<float> position( -0.05f, 1.0f );
+	for ( unsigned int spriteNum = 0; spriteNum < numSprites; spriteNum++ )
+	{
+		const float x = position( random );
+		const float y = position( random );
+		graphics->drawSprite( x, y, *assets.sprites[random() % assets.sprites.size()] );
+	}
+}
+
+// a page of small text in a few colors
+static void drawTextPage (SceneGraphics* graphics, SceneAssets& assets)
+{
+	graphics->setColor( 1.0f, 1.0f, 0.95f );
+	graphics->fill();
+
+	const char* lines[] = {
+		"SIGL scene benchmark: text page",
+		"The quick brown fox jumps over",
+		"the lazy dog. 0123456789 !?#$%&",
+		"Pack my box with five dozen",
+		"liquor jugs. [brackets] {braces}",
+	};
+	constexpr unsigned int numLines = sizeof( lines ) / sizeof( lines[0] );
+
+	const float lineHeight = static_cast<float>( assets.font->getBitmapHeight() + 1 ) / SCENE_HEIGHT;
+	for ( unsigned int lineNum = 0; lineNum * lineHeight < 1.0f; lineNum++ )
+	{
+		const float shade = ( lineNum % 4 == 0 ) ? 0.6f : 0.1f;
+		graphics->setColor( shade * 0.3f, shade * 0.3f, shade );
+		graphics->drawText( 0.01f, lineNum * lineHeight, lines[lineNum % numLines], 1.0f );
+	}
+}
+
+// a dashboard kept in a scene graph, where a sprite moves across the panels by one step each frame, so only the areas it leaves and
+// enters are redrawn. The sprite's position only depends on the frame number, so any frame can also be drawn from scratch
+class SceneGraphScene
+{
+	public:
+		SceneGraphScene (SceneAssets& assets) :
+			m_Nodes(),
+			m_SceneGraph(),
+			m_MovingNode( nullptr )
+		{
+			m_SceneGraph.setBackgroundColor( 0.08f, 0.09f, 0.12f );
+			SceneGroupNode<RENDER_API::SOFTWARE>& panels = this->addNode( m_SceneGraph.getRoot(),
+										std::make_unique<SceneGroupNode<RENDER_API::SOFTWARE>>() );
+
+			constexpr unsigned int panelCols = 3;
+			constexpr unsigned int panelRows = 2;
+			constexpr float panelWidth = 1.0f / panelCols;
+			constexpr float panelHeight = 1.0f / panelRows;
+			constexpr float margin = 0.02f;
+			for ( unsigned int panelNum = 0; panelNum < panelCols * panelRows; panelNum++ )
+			{
+				const float left = ( panelNum % panelCols ) * panelWidth + margin;
+				const float top = ( panelNum / panelCols ) * panelHeight + margin;
+				const float right = left + panelWidth - ( margin * 2.0f );
+				const float bottom = top + panelHeight - ( margin * 2.0f );
+				const float centerX = ( left + right ) / 2.0f;
+				const float centerY = ( top + bottom ) / 2.0f + margin;
+				const float radius = ( bottom - top ) * 0.25f;
+
+				this->addNode( panels, std::make_unique<SceneBoxNode<RENDER_API::SOFTWARE>>(left, top, right, bottom) )
+					.setColor( 0.16f, 0.18f, 0.22f );
+				this->addNode( panels, std::make_unique<SceneBoxNode<RENDER_API::SOFTWARE>>(left, top, right, bottom, false) )
+					.setColor( 0.35f, 0.4f, 0.5f );
+				this->addNode( panels, std::make_unique<SceneTextNode<RENDER_API::SOFTWARE>>(left + margin, top + margin,
+							"CH " + std::to_string(panelNum), assets.font.get()) ).setColor( 0.9f, 0.9f, 0.9f );
+				this->addNode( panels, std::make_unique<SceneCircleNode<RENDER_API::SOFTWARE>>(centerX, centerY, radius) )
+					.setColor( 0.3f, 0.8f, 0.4f );
+				this->addNode( panels, std::make_unique<SceneLineNode<RENDER_API::SOFTWARE>>(centerX, centerY, centerX + radius,
+							centerY - radius) ).setColor( 1.0f, 0.6f, 0.1f );
+			}
+
+			// added last so that it's drawn over the panels
+			m_MovingNode = &this->addNode( m_SceneGraph.getRoot(),
+					std::make_unique<SceneSpriteNode<CP_FORMAT::RGBA_32BIT, RENDER_API::SOFTWARE>>(0.0f, 0.0f, *assets.sprites[0]) );
+		}
+
+		// moves the sprite to where it is in frameNum, the path repeats every SCENE_GRAPH_PATH_FRAMES frames
+		void moveTo (unsigned int frameNum)
+		{
+			const float pathFraction = static_cast<float>( frameNum % SCENE_GRAPH_PATH_FRAMES ) / SCENE_GRAPH_PATH_FRAMES;
+			std::lock_guard<std::mutex> lock( m_SceneGraph.getMutex() );
+			m_MovingNode->setPosition( -0.05f + pathFraction, 0.1f + (pathFraction * 0.7f) );
+		}
+
+		void draw (SceneGraphics* graphics) { m_SceneGraph.draw( *graphics ); }
+
+	private:
+		// the nodes come before the scene graph, since they have to outlive it
+		std::vector<std::unique_ptr<SceneNode<RENDER_API::SOFTWARE>>> 				m_Nodes;
+		SceneGraph<RENDER_API::SOFTWARE> 							m_SceneGraph;
+		SceneSpriteNode<CP_FORMAT::RGBA_32BIT, RENDER_API::SOFTWARE>* 				m_MovingNode;
+
+		template <typename NodeType>
+		NodeType& addNode (SceneGroupNode<RENDER_API::SOFTWARE>& parent, std::unique_ptr<NodeType> node)
+		{
+			NodeType& nodeRef = *node;
+			parent.addChild( nodeRef );
+			m_Nodes.push_back( std::move(node) );
+
+			return nodeRef;
+		}
+};
+
+template <unsigned int numRenderThreads>
+class SceneBenchmarkSurface : public Surface<RENDER_API::SOFTWARE, SCENE_WIDTH, SCENE_HEIGHT, SCENE_FORMAT, numRenderThreads, true,
+						SCENE_SHADER_PASS_DATA_SIZE>
+{
+	public:
+		SceneBenchmarkSurface (SCENE scene, SceneAssets& assets) :
+			m_Scene( scene ),
+			m_Assets( assets ),
+			m_SceneGraphScene( (scene == SCENE::SCENE_GRAPH) ? std::make_unique<SceneGraphScene>(assets) : nullptr ),
+			m_SceneGraphMutex(),
+			m_SceneGraphFrameNum( 0 ),
+			m_SceneGraphFrames()
+		{
+		}
+
+		// draw is called from the render threads, so it only uses the assets and the graphics object it's given
+		void draw (SceneGraphics* graphics) override
+		{
+			graphics->setFont( m_Assets.font.get() );
+
+			switch ( m_Scene )
+			{
+				case SCENE::DASHBOARD:
+					drawDashboard( graphics, m_Assets );
+					break;
+				case SCENE::DASHBOARD_DISPLAY_LIST:
+					m_Assets.dashboardDisplayList.replay( *graphics );
+					break;
+				case SCENE::OBJ_MODEL:
+					drawObjModel( graphics, m_Assets );
+					break;
+				case SCENE::OBJ_MODEL_TILED:
+					graphics->setTiledRendering( true );
+					drawObjModel( graphics, m_Assets );
+					break;
+				case SCENE::OBJ_MODEL_DEPTH_PRE_PASS:
+					graphics->setDepthPrePass( true );
+					drawObjModel( graphics, m_Assets );
+					break;
+				case SCENE::SPRITE_STORM:
+					drawSpriteStorm( graphics, m_Assets );
+					break;
+				case SCENE::TEXT_PAGE:
+					drawTextPage( graphics, m_Assets );
+					break;
+				case SCENE::SCENE_GRAPH:
+				{
+					// frames are drawn one at a time, so that it's known which frame each buffer holds
+					std::lock_guard<std::mutex> lock( m_SceneGraphMutex );
+					m_SceneGraphScene->moveTo( m_SceneGraphFrameNum );
+					m_SceneGraphScene->draw( graphics );
+					this->setSceneGraphFrame( &graphics->getFrameBuffer(), m_SceneGraphFrameNum );
+					m_SceneGraphFrameNum++;
+				}
+					break;
+				default:
+					break;
+			}
+		}
+
+		// the frame of the scene graph that was last drawn into frameBuffer
+		unsigned int getSceneGraphFrame (const SceneFrameBuffer* frameBuffer)
+		{
+			std::lock_guard<std::mutex> lock( m_SceneGraphMutex );
+			for ( const SceneGraphFrame& frame : m_SceneGraphFrames )
+			{
+				if ( frame.frameBuffer == frameBuffer ) return frame.frameNum;
+			}
+
+			return 0;
+		}
+
+	private:
+		struct SceneGraphFrame
+		{
+			const SceneFrameBuffer* 	frameBuffer;
+			unsigned int 			frameNum;
+		};
+
+		SCENE 					m_Scene;
+		SceneAssets& 				m_Assets;
+		std::unique_ptr<SceneGraphScene> 	m_SceneGraphScene; // only for SCENE::SCENE_GRAPH
+		std::mutex 				m_SceneGraphMutex;
+		unsigned int 				m_SceneGraphFrameNum;
+		std::vector<SceneGraphFrame> 		m_SceneGraphFrames;
+
+		void setSceneGraphFrame (const SceneFrameBuffer* frameBuffer, unsigned int frameNum)
+		{
+			for ( SceneGraphFrame& frame : m_SceneGraphFrames )
+			{
+				if ( frame.frameBuffer == frameBuffer )
+				{
+					frame.frameNum = frameNum;
+					return;
+				}
+			}
+
+			m_SceneGraphFrames.push_back( SceneGraphFrame{frameBuffer, frameNum} );
+		}
+};
+
+#ifdef PERSPECTIVE_SUBDIVISION
+constexpr float PERSPECTIVE_CHECK_SLACK = 1e-4f; // for float rounding, which the bound leaves out
+
+// the tex coords each fragment of the perspective check was shaded with, indexed by the fragment's color minus one
+static std::vector<std::array<float, 2>> perspectiveCheckTexCoords;
+
+template <CP_FORMAT format, RENDER_API api, unsigned int shaderPassDataSize>
+static void perspectiveCheckFShader (Color& colorOut, TriShaderData<format, api, shaderPassDataSize>& /*fShaderData*/, float /*v1Cur*/,
+					float /*v2Cur*/, float /*v3Cur*/, float texCoordX, float texCoordY, float /*lightAmnt*/)
+{
+	perspectiveCheckTexCoords.push_back( {texCoordX, texCoordY} );
+
+	// halfway between two steps, so that each channel converts back to exactly these bytes
+	const unsigned int fragmentId = perspectiveCheckTexCoords.size();
+	colorOut.m_R = ( static_cast<float>((fragmentId >> 16) & 0xFF) + 0.5f ) / 255.0f;
+	colorOut.m_G = ( static_cast<float>((fragmentId >> 8) & 0xFF) + 0.5f ) / 255.0f;
+	colorOut.m_B = ( static_cast<float>(fragmentId & 0xFF) + 0.5f ) / 255.0f;
+	colorOut.m_A = 1.0f;
+	colorOut.m_M = true;
+}
+
+// a vertex in screen space with its tex coords divided by w, which are linear in screen space along with 1 / w
+struct PerspectiveCheckVertex
+{
+	double x;
+	double y;
+	double pers;
+	double texXOverW;
+	double texYOverW;
+};
+
+// the perspective correct tex coords and 1 / w at a pixel, computed in double from the projected vertices
+struct PerspectiveCheckTexCoords
+{
+	double texX;
+	double texY;
+	double pers;
+};
+
+static PerspectiveCheckTexCoords perspectiveCheckReference (const std::array<PerspectiveCheckVertex, 3>& vertices, double x, double y)
+{
+	const PerspectiveCheckVertex& v1 = vertices[0];
+	const PerspectiveCheckVertex& v2 = vertices[1];
+	const PerspectiveCheckVertex& v3 = vertices[2];
+	const double area = ( (v2.x - v1.x) * (v3.y - v1.y) ) - ( (v3.x - v1.x) * (v2.y - v1.y) );
+	const double weight2 = ( ((x - v1.x) * (v3.y - v1.y)) - ((v3.x - v1.x) * (y - v1.y)) ) / area;
+	const double weight3 = ( ((v2.x - v1.x) * (y - v1.y)) - ((x - v1.x) * (v2.y - v1.y)) ) / area;
+	const double weight1 = 1.0 - weight2 - weight3;
+
+	const double pers = ( weight1 * v1.pers ) + ( weight2 * v2.pers ) + ( weight3 * v3.pers );
+	const double texXOverW = ( weight1 * v1.texXOverW ) + ( weight2 * v2.texXOverW ) + ( weight3 * v3.texXOverW );
+	const double texYOverW = ( weight1 * v1.texYOverW ) + ( weight2 * v2.texYOverW ) + ( weight3 * v3.texYOverW );
+
+	return { texXOverW / pers, texYOverW / pers, pers };
+}
+
+struct PerspectiveCheckResult
+{
+	unsigned int 	numPixels = 0;
+	unsigned int 	numPixelsOverBound = 0;
+	double 		maxError = 0.0;
+	double 		maxBound = 0.0;
+};
+
+// draws a textured wall that recedes to the right, so that 1 / w changes a lot across each span, and checks that the tex coords
+// of every pixel are within perspectiveSubdivisionErrorBound of the perspective correct ones
+class PerspectiveCheckSurface : public Surface<RENDER_API::SOFTWARE, SCENE_WIDTH, SCENE_HEIGHT, SCENE_FORMAT, 1, true,
+						SCENE_SHADER_PASS_DATA_SIZE>
+{
+	public:
+		PerspectiveCheckSurface (SceneAssets& assets) :
+			m_Assets( assets ),
+			m_Result()
+		{
+		}
+
+		void draw (SceneGraphics* graphics) override
+		{
+			graphics->setColor( 0.0f, 0.0f, 0.0f );
+			graphics->fill();
+
+			std::array<Texture<SCENE_FORMAT, RENDER_API::SOFTWARE>*, 5> textures = { m_Assets.modelTexture.get(), nullptr, nullptr,
+													nullptr, nullptr };
+			Camera3D camera( 0.1f, 100.0f, 90.0f, static_cast<float>(SCENE_HEIGHT) / static_cast<float>(SCENE_WIDTH) );
+			TriShaderData<SCENE_FORMAT, RENDER_API::SOFTWARE, SCENE_SHADER_PASS_DATA_SIZE> shaderData{ textures, camera, Color(), nullptr,
+				sceneModelVShader<SCENE_FORMAT, RENDER_API::SOFTWARE, SCENE_SHADER_PASS_DATA_SIZE>,
+				perspectiveCheckFShader<SCENE_FORMAT, RENDER_API::SOFTWARE, SCENE_SHADER_PASS_DATA_SIZE> };
+
+			const Face wall{{
+				{ {{-1.2f, -0.8f, 1.5f, 1.0f}}, {{-1.0f, 0.0f, -1.0f, 0.0f}}, {{0.0f, 0.0f}} },
+				{ {{-1.2f,  0.8f, 1.5f, 1.0f}}, {{-1.0f, 0.0f, -1.0f, 0.0f}}, {{0.0f, 4.0f}} },
+				{ {{ 6.0f,  0.0f, 9.0f, 1.0f}}, {{-1.0f, 0.0f, -1.0f, 0.0f}}, {{8.0f, 2.0f}} }
+			}};
+
+			// projected the same way drawTriangleShaded projects them, the wall is entirely inside of the view so it isn't clipped
+			std::array<PerspectiveCheckVertex, 3> screenVertices;
+			for ( unsigned int vertNum = 0; vertNum < 3; vertNum++ )
+			{
+				Vertex vertex = wall.vertices[vertNum];
+				camera.multiplyByCameraMatrix( vertex );
+				camera.perspectiveDivide( vertex );
+				camera.scaleXYToZeroToOne( vertex );
+				const double pers = 1.0 / vertex.vec.w();
+				screenVertices[vertNum] = { vertex.vec.x() * static_cast<double>(SCENE_WIDTH - 1),
+								vertex.vec.y() * static_cast<double>(SCENE_HEIGHT - 1), pers,
+								vertex.texCoords.x() * pers, vertex.texCoords.y() * pers };
+			}
+
+			perspectiveCheckTexCoords.clear();
+			Face face = wall;
+			graphics->drawTriangleShaded( face, shaderData );
+
+			// the frame buffer holds the fragment that was shaded for each pixel, and the fragments of a row make up its span
+			const auto& pixels = graphics->getFrameBuffer().getPixels();
+			const int subdivLength = static_cast<int>( PERSPECTIVE_SUBDIVISION_LENGTH );
+			for ( unsigned int row = 0; row < SCENE_HEIGHT; row++ )
+			{
+				std::array<unsigned int, SCENE_WIDTH> fragmentIds;
+				int spanLeftX = SCENE_WIDTH;
+				int spanRightX = 0;
+				for ( unsigned int col = 0; col < SCENE_WIDTH; col++ )
+				{
+					const unsigned int pixelNum = ( (row * SCENE_WIDTH) + col ) * 3;
+					fragmentIds[col] = ( pixels[pixelNum] << 16 ) | ( pixels[pixelNum + 1] << 8 ) | pixels[pixelNum + 2];
+					if ( fragmentIds[col] != 0 )
+					{
+						spanLeftX = std::min( spanLeftX, static_cast<int>(col) );
+						spanRightX = static_cast<int>( col ) + 1;
+					}
+				}
+
+				for ( int col = spanLeftX; col < spanRightX; col++ )
+				{
+					if ( fragmentIds[col] == 0 || fragmentIds[col] > perspectiveCheckTexCoords.size() ) continue;
+
+					const int subdivX = ( col / subdivLength ) * subdivLength;
+					const int subdivStartX = std::max( subdivX, spanLeftX );
+					const int subdivEndX = std::min( subdivX + subdivLength, spanRightX - 1 );
+					const PerspectiveCheckTexCoords expected = perspectiveCheckReference( screenVertices, col, row );
+					const PerspectiveCheckTexCoords subdivStart = perspectiveCheckReference( screenVertices, subdivStartX, row );
+					const PerspectiveCheckTexCoords subdivEnd = perspectiveCheckReference( screenVertices, subdivEndX, row );
+					const std::array<float, 2>& texCoords = perspectiveCheckTexCoords[fragmentIds[col] - 1];
+
+					const double errorX = std::abs( texCoords[0] - expected.texX );
+					const double errorY = std::abs( texCoords[1] - expected.texY );
+					const double boundX = perspectiveSubdivisionErrorBound( subdivStart.texX, subdivEnd.texX, subdivStart.pers,
+													subdivEnd.pers );
+					const double boundY = perspectiveSubdivisionErrorBound( subdivStart.texY, subdivEnd.texY, subdivStart.pers,
+													subdivEnd.pers );
+
+					m_Result.numPixels++;
+					m_Result.maxError = std::max( {m_Result.maxError, errorX, errorY} );
+					m_Result.maxBound = std::max( {m_Result.maxBound, boundX, boundY} );
+					if ( errorX > boundX + PERSPECTIVE_CHECK_SLACK || errorY > boundY + PERSPECTIVE_CHECK_SLACK )
+					{
+						m_Result.numPixelsOverBound++;
+					}
+				}
+			}
+		}
+
+		const PerspectiveCheckResult& getResult() const { return m_Result; }
+
+	private:
+		SceneAssets& 		m_Assets;
+		PerspectiveCheckResult 	m_Result;
+};
+
+// sets matches to false if any tex coord is further from the perspective correct one than the bound
+static void checkPerspectiveSubdivision (SceneAssets& assets, bool& matches)
+{
+	std::vector<uint8_t> graphicsMemory( (sizeof(SceneGraphics) * 2) + 1 );
+	std::unique_ptr<PerspectiveCheckSurface> surface = std::make_unique<PerspectiveCheckSurface>( assets );
+#ifdef NO_GPU
+	surface->placeGraphicsObjectsInMemory( graphicsMemory.data(), graphicsMemory.size() );
+#endif
+
+	// the check is done while drawing, so a single frame is enough
+	surface->render();
+	surface->advanceFrameBuffer();
+
+	const PerspectiveCheckResult& result = surface->getResult();
+	const bool withinBound = result.numPixels > 0 && result.numPixelsOverBound == 0;
+	matches = matches && withinBound;
+
+	std::printf( "check,name,subdivision_length,pixels,max_error,max_bound,pixels_over_bound\n" );
+	std::printf( "check,perspective_subdivision,%u,%u,%.6f,%.6f,%u\n", PERSPECTIVE_SUBDIVISION_LENGTH, result.numPixels, result.maxError,
+			result.maxBound, result.numPixelsOverBound );
+	std::fflush( stdout );
+}
+#endif
+
+struct SceneOptions
+{
+	unsigned int 	numFrames = 60;
+	unsigned int 	tolerance = 0;
+	bool 		updateGolden = false;
+	std::string 	assetsDirectory = "benchmarks/assets";
+	std::string 	goldenDirectory = "benchmarks/golden";
+};
+
+// the scene whose golden image a scene is compared against
+static SCENE goldenScene (SCENE scene)
+{
+	switch ( scene )
+	{
+		// a replayed display list has to draw exactly what drawing directly does
+		case SCENE::DASHBOARD_DISPLAY_LIST:
+			return SCENE::DASHBOARD;
+		// and so does deferring the triangles to tiles or to a depth pre-pass
+		case SCENE::OBJ_MODEL_TILED:
+		case SCENE::OBJ_MODEL_DEPTH_PRE_PASS:
+			return SCENE::OBJ_MODEL;
+		default:
+			return scene;
+	}
+}
+
+static std::string goldenImagePath (const SceneOptions& options, SCENE scene)
+{
+	// perspective subdivision only approximates the tex coords of the model, so it has its own golden image for each length
+	if ( PERSPECTIVE_SUBDIVISION_LENGTH != 0 && goldenScene(scene) == SCENE::OBJ_MODEL )
+	{
+		return options.goldenDirectory + "/" + sceneName( goldenScene(scene) ) + "_subdivision_"
+			+ std::to_string( PERSPECTIVE_SUBDIVISION_LENGTH ) + ".ppm";
+	}
+
+	return options.goldenDirectory + "/" + sceneName( goldenScene(scene) ) + ".ppm";
+}
+
+// golden images are binary ppm files, which hold the rgb frame buffer as is
+static bool writeGoldenImage (const std::string& filePath, SceneFrameBuffer& frameBuffer)
+{
+	std::ofstream file( filePath, std::ios::binary );
+	if ( ! file ) return false;
+
+	file << "P6\n" << SCENE_WIDTH << " " << SCENE_HEIGHT << "\n255\n";
+	file.write( reinterpret_cast<const char*>(frameBuffer.getPixels().data()), frameBuffer.getPixels().size() );
+
+	return static_cast<bool>( file );
+}
+
+static bool readGoldenImage (const std::string& filePath, std::vector<uint8_t>& pixelsOut)
+{
+	std::ifstream file( filePath, std::ios::binary );
+	if ( ! file ) return false;
+
+	std::string magic;
+	unsigned int imageWidth = 0;
+	unsigned int imageHeight = 0;
+	unsigned int maxValue = 0;
+	file >> magic >> imageWidth >> imageHeight >> maxValue;
+	file.get(); // the single whitespace after the header
+	if ( magic != "P6" || imageWidth != SCENE_WIDTH || imageHeight != SCENE_HEIGHT || maxValue != 255 ) return false;
+
+	pixelsOut.resize( SCENE_WIDTH * SCENE_HEIGHT * 3 );
+	file.read( reinterpret_cast<char*>(pixelsOut.data()), pixelsOut.size() );
+
+	return static_cast<bool>( file );
+}
+
+// returns a short description of how the frame compares to the golden image, and sets matches to false if it doesn't match
+static std::string checkGoldenImage (const SceneOptions& options, SCENE scene, SceneFrameBuffer& frameBuffer, bool& matches)
+{
+	const std::string filePath = goldenImagePath( options, scene );
+	if ( options.updateGolden && goldenScene(scene) == scene )
+	{
+		if ( writeGoldenImage(filePath, frameBuffer) ) return "updated";
+
+		matches = false;
+		return "write_failed";
+	}
+
+	std::vector<uint8_t> goldenPixels;
+	if ( ! readGoldenImage(filePath, goldenPixels) )
+	{
+		matches = false;
+		return "missing";
+	}
+
+	unsigned int numDifferentPixels = 0;
+	for ( unsigned int pixelNum = 0; pixelNum < SCENE_WIDTH * SCENE_HEIGHT; pixelNum++ )
+	{
+		for ( unsigned int channel = 0; channel < 3; channel++ )
+		{
+			const int difference = frameBuffer.getPixels()[(pixelNum * 3) + channel] - goldenPixels[(pixelNum * 3) + channel];
+			if ( static_cast<unsigned int>(std::abs(difference)) > options.tolerance )
+			{
+				numDifferentPixels++;
+				break;
+			}
+		}
+	}
+
+	if ( numDifferentPixels == 0 ) return "match";
+
+	matches = false;
+	return "mismatch_" + std::to_string( numDifferentPixels ) + "_pixels";
+}
+
+// draws a frame of the scene graph from scratch, which a new scene graph always does, since it hasn't drawn into the graphics object
+class SceneGraphRedrawSurface : public Surface<RENDER_API::SOFTWARE, SCENE_WIDTH, SCENE_HEIGHT, SCENE_FORMAT, 1, true,
+						SCENE_SHADER_PASS_DATA_SIZE>
+{
+	public:
+		SceneGraphRedrawSurface (SceneAssets& assets) :
+			m_Assets( assets ),
+			m_FrameNum( 0 )
+		{
+		}
+
+		void draw (SceneGraphics* graphics) override
+		{
+			graphics->setFont( m_Assets.font.get() );
+
+			SceneGraphScene scene( m_Assets );
+			scene.moveTo( m_FrameNum );
+			scene.draw( graphics );
+		}
+
+		void setFrameNum (unsigned int frameNum) { m_FrameNum = frameNum; }
+
+	private:
+		SceneAssets& 	m_Assets;
+		unsigned int 	m_FrameNum;
+};
+
+// renders SCENE_GRAPH_CHECK_FRAMES more frames, and checks that every frame returned matches a full redraw of the same frame, and
+// that every pixel that changed since the frame returned before it is inside of the surface's damage. Returns a short description
+// like checkGoldenImage does, and sets matches to false if either check fails
+template <unsigned int numRenderThreads>
+static std::string checkSceneGraphFrames (SceneBenchmarkSurface<numRenderThreads>& surface, SceneFrameBuffer& lastFrameBuffer,
+						SceneAssets& assets, bool& matches)
+{
+	std::vector<uint8_t> redrawMemory( (sizeof(SceneGraphics) * 2) + 1 );
+	std::unique_ptr<SceneGraphRedrawSurface> redrawSurface = std::make_unique<SceneGraphRedrawSurface>( assets );
+#ifdef NO_GPU
+	redrawSurface->placeGraphicsObjectsInMemory( redrawMemory.data(), redrawMemory.size() );
+#endif
+	// a single core surface renders its first two frames to the same buffer, so the first buffer it returns was never rendered to
+	redrawSurface->render();
+	redrawSurface->advanceFrameBuffer();
+
+	std::vector<uint8_t> previousPixels( lastFrameBuffer.getPixels().begin(), lastFrameBuffer.getPixels().end() );
+	unsigned int numDifferentFrames = 0;
+	unsigned int numUndamagedPixels = 0;
+	for ( unsigned int checkNum = 0; checkNum < SCENE_GRAPH_CHECK_FRAMES; checkNum++ )
+	{
+		surface.render();
+		SceneFrameBuffer& frameBuffer = surface.advanceFrameBuffer();
+		const uint8_t* pixels = frameBuffer.getPixels().data();
+
+		redrawSurface->setFrameNum( surface.getSceneGraphFrame(&frameBuffer) );
+		redrawSurface->render();
+		const uint8_t* redrawPixels = redrawSurface->advanceFrameBuffer().getPixels().data();
+		if ( std::memcmp(pixels, redrawPixels, SCENE_WIDTH * SCENE_HEIGHT * 3) != 0 )
+		{
+			numDifferentFrames++;
+		}
+
+		const DamageList& damage = surface.getDamage();
+		for ( unsigned int pixelNum = 0; pixelNum < SCENE_WIDTH * SCENE_HEIGHT; pixelNum++ )
+		{
+			if ( std::memcmp(&pixels[pixelNum * 3], &previousPixels[pixelNum * 3], 3) == 0 ) continue;
+
+			const unsigned int x = pixelNum % SCENE_WIDTH;
+			const unsigned int y = pixelNum / SCENE_WIDTH;
+			const bool damaged = std::any_of( damage.begin(), damage.end(), [x, y](const DamageRect& rect)
+					{ return x >= rect.xMin && x < rect.xMaxExclusive && y >= rect.yMin && y < rect.yMaxExclusive; } );
+			if ( ! damaged )
+			{
+				numUndamagedPixels++;
+			}
+		}
+		std::memcpy( previousPixels.data(), pixels, previousPixels.size() );
+	}
+
+	// wait for the frames still rendering, since the surface is destroyed after this
+	for ( unsigned int bufferNum = 0; bufferNum < numRenderThreads - 1; bufferNum++ )
+	{
+		surface.advanceFrameBuffer();
+	}
+
+	if ( numDifferentFrames == 0 && numUndamagedPixels == 0 ) return "match";
+
+	matches = false;
+	if ( numDifferentFrames != 0 ) return "mismatch_" + std::to_string( numDifferentFrames ) + "_frames";
+
+	return "undamaged_" + std::to_string( numUndamagedPixels ) + "_pixels";
+}
+
+template <unsigned int numRenderThreads>
+static void runSceneBenchmark (const SceneOptions& options, SCENE scene, SceneAssets& assets, bool& matches)
+{
+	using SurfaceType = SceneBenchmarkSurface<numRenderThreads>;
+
+	// the frame buffers are too big for the stack
+	std::vector<uint8_t> graphicsMemory( (sizeof(SceneGraphics) * 2) + 1 );
+	std::unique_ptr<SurfaceType> surface = std::make_unique<SurfaceType>( scene, assets );
+#ifdef NO_GPU
+	if constexpr ( numRenderThreads == 1 )
+	{
+		surface->placeGraphicsObjectsInMemory( graphicsMemory.data(), graphicsMemory.size() );
+	}
+#endif
+
+	// the damage of each frame returned is how much of the screen a display that keeps the last frame would have to be sent
+	uint64_t damageArea = 0;
+	unsigned int numFramesReturned = 0;
+	auto advanceFrameBuffer = [&surface, &damageArea, &numFramesReturned]() -> SceneFrameBuffer&
+		{
+			SceneFrameBuffer& frameBuffer = surface->advanceFrameBuffer();
+			damageArea += surface->getDamage().getArea();
+			numFramesReturned++;
+
+			return frameBuffer;
+		};
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if constexpr ( numRenderThreads == 1 )
+	{
+		for ( unsigned int frameNum = 0; frameNum < options.numFrames; frameNum++ )
+		{
+			surface->render();
+			advanceFrameBuffer();
+		}
+	}
+	else
+	{
+		// keep every render thread busy, only reading a frame when there's no free buffer to render to
+		unsigned int framesRendered = 0;
+		while ( framesRendered < options.numFrames )
+		{
+			if ( surface->render() )
+			{
+				framesRendered++;
+			}
+			else
+			{
+				advanceFrameBuffer();
+			}
+		}
+
+		// wait for the frames still rendering
+		for ( unsigned int bufferNum = 0; bufferNum < numRenderThreads - 1; bufferNum++ )
+		{
+			advanceFrameBuffer();
+		}
+	}
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	// with at least SCENE_MIN_FRAMES frames every buffer has been rendered to and finished by now, and all frames of a scene are
+	// the same, except for the scene graph, which is checked against full redraws instead
+	SceneFrameBuffer& frameBuffer = advanceFrameBuffer();
+	const std::string golden = ( scene == SCENE::SCENE_GRAPH ) ? checkSceneGraphFrames( *surface, frameBuffer, assets, matches )
+									: checkGoldenImage( options, scene, frameBuffer, matches );
+
+	const double seconds = std::chrono::duration<double>( end - start ).count();
+	std::printf( "scene,%s,%u,%u,%u,%s,%u,%.2f,%.3f,%llu,%s\n", benchmarkFormatName(SCENE_FORMAT), SCENE_WIDTH, SCENE_HEIGHT,
+			numRenderThreads, sceneName(scene), options.numFrames, options.numFrames / seconds, (seconds * 1000.0) / options.numFrames,
+			static_cast<unsigned long long>(damageArea / numFramesReturned), golden.c_str() );
+	std::fflush( stdout );
+}
+
+template <unsigned int numRenderThreads>
+static void runSceneBenchmarks (const SceneOptions& options, SCENE scene, SceneAssets& assets, bool& matches)
+{
+	runSceneBenchmark<numRenderThreads>( options, scene, assets, matches );
+
+	// golden images are only written once, with the single threaded surface
+	if constexpr ( numRenderThreads < SCENE_MAX_RENDER_THREADS )
+	{
+		if ( ! options.updateGolden )
+		{
+			runSceneBenchmarks<numRenderThreads + 1>( options, scene, assets, matches );
+		}
+	}
+}
+
+int main (int argc, char* argv[])
+{
+	SceneOptions options;
+	for ( int argNum = 1; argNum < argc; argNum++ )
+	{
+		const std::string arg = argv[argNum];
+		const bool hasValue = argNum + 1 < argc;
+		if ( arg == "--frames" && hasValue )
+		{
+			options.numFrames = std::max( std::atoi(argv[++argNum]), static_cast<int>(SCENE_MIN_FRAMES) );
+		}
+		else if ( arg == "--tolerance" && hasValue )
+		{
+			options.tolerance = std::max( std::atoi(argv[++argNum]), 0 );
+		}
+		else if ( arg == "--update-golden" )
+		{
+			options.updateGolden = true;
+		}
+		else if ( arg == "--assets" && hasValue )
+		{
+			options.assetsDirectory = argv[++argNum];
+		}
+		else if ( arg == "--golden" && hasValue )
+		{
+			options.goldenDirectory = argv[++argNum];
+		}
+		else
+		{
+			std::fprintf( stderr, "unknown argument %s\n", arg.c_str() );
+			return 2;
+		}
+	}
+
+	SceneAssets assets;
+	if ( ! loadSceneAssets(assets, options.assetsDirectory) )
+	{
+		std::fprintf( stderr, "couldn't load the assets from %s\n", options.assetsDirectory.c_str() );
+		return 2;
+	}
+
+	bool matches = true;
+	std::printf( "benchmark,format,width,height,threads,name,frames,fps,ms_per_frame,damage_per_frame,golden\n" );
+	for ( SCENE scene : {SCENE::DASHBOARD, SCENE::DASHBOARD_DISPLAY_LIST, SCENE::OBJ_MODEL, SCENE::OBJ_MODEL_TILED,
+				SCENE::OBJ_MODEL_DEPTH_PRE_PASS, SCENE::SPRITE_STORM, SCENE::TEXT_PAGE, SCENE::SCENE_GRAPH} )
+	{
+		runSceneBenchmarks<1>( options, scene, assets, matches );
+	}
+
+#ifdef PERSPECTIVE_SUBDIVISION
+	checkPerspectiveSubdivision( assets, matches );
+#endif
+
+	return matches ? 0 : 1;
+}
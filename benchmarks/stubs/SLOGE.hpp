@@ -0,0 +1,31 @@
+#ifndef SLOGE_HPP
+#define SLOGE_HPP
+
+/**************************************************************************
+ * A stand in for the SLOGE logging library, so that the benchmarks build
+ * without it. It only has what SIGL logs with, and drops every message.
+ * The CMake build only uses it when SLOGE.hpp isn't found.
+**************************************************************************/
+
+#include <string>
+
+enum class LogLevels
+{
+	INFO,
+	ERROR
+};
+
+enum class LogMethodsE
+{
+	INFO,
+	ERROR
+};
+
+class SLOG
+{
+	public:
+		static void log (LogLevels /*level*/, LogMethodsE /*method*/, const std::string& /*message*/, int /*line*/ = 0,
+					const char* /*file*/ = "") {}
+};
+
+#endif // SLOGE_HPP
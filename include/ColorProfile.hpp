@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <array>
+#include <cstring>
 #include <math.h>
 
 enum class RENDER_API
@@ -45,6 +46,15 @@ struct Color
 	}
 };
 
+// how the pixels drawn are combined with the pixels already in a monochrome frame buffer, the other formats always copy
+enum class RASTER_OP
+{
+	COPY,
+	OR,
+	AND,
+	XOR
+};
+
 enum class CP_FORMAT
 {
 	MONOCHROME_1BIT,
@@ -72,6 +82,29 @@ class ColorProfileCommon
 		uint8_t m_BValue;
 		uint8_t m_AValue;
 		bool    m_MValue; // for monochrome
+
+		// spans shorter than this are written a pixel at a time, since building the pattern would cost more than it saves
+		static constexpr unsigned int m_MinPatternSpanPixels = 16;
+		// a multiple of both 3 and 4 byte pixels, and a whole number of 16 byte vector registers
+		static constexpr unsigned int m_PatternSize = 48;
+
+		// writes numBytes bytes of the pixelSize byte pixel repeatedly to bytes. The pattern is copied in fixed size blocks, which
+		// compilers turn into unaligned vector stores
+		static inline void putPattern (uint8_t* bytes, const uint8_t* pixel, unsigned int pixelSize, unsigned int numBytes)
+		{
+			std::array<uint8_t, m_PatternSize> pattern;
+			for ( unsigned int byteNum = 0; byteNum < m_PatternSize; byteNum++ )
+			{
+				pattern[byteNum] = pixel[byteNum % pixelSize];
+			}
+
+			unsigned int byteNum = 0;
+			for ( ; byteNum + m_PatternSize <= numBytes; byteNum += m_PatternSize )
+			{
+				std::memcpy( &bytes[byteNum], pattern.data(), m_PatternSize );
+			}
+			std::memcpy( &bytes[byteNum], pattern.data(), numBytes - byteNum );
+		}
 };
 
 template <CP_FORMAT format>
@@ -82,18 +115,12 @@ class ColorProfileMonochrome : public ColorProfileCommon
 		void putPixel (std::array<uint8_t, (width * height) / 8>& pixelArray, unsigned int pixelNum)
 		{
 #ifdef ROTATE_DISPLAY_180_DEGREES
-			pixelNum = fbNumPixels - 1 - pixelNum;
+			pixelNum = ( width * height ) - 1 - pixelNum;
 #endif
-			unsigned int byteNum = std::floor( pixelNum / 8 );
-			unsigned int pixelIndex = 7 - (pixelNum % 8);
-			uint8_t bitmask = ( 1 << pixelIndex );
-			if ( m_MValue == true && m_AValue > 0 )
-			{
-				pixelArray[byteNum] = pixelArray[byteNum] | bitmask;
-			}
-			else if ( m_AValue > 0 )
+			if ( m_AValue > 0 )
 			{
-				pixelArray[byteNum] = pixelArray[byteNum] & ~(bitmask);
+				// pixels are stored from the most significant bit down
+				pixelArray[pixelNum / 8] = applyRasterOp( pixelArray[pixelNum / 8], static_cast<uint8_t>(0x80 >> (pixelNum % 8)) );
 			}
 		}
 
@@ -102,42 +129,92 @@ class ColorProfileMonochrome : public ColorProfileCommon
 		{
 			for ( unsigned int pixelNum = pixelStart; pixelNum < numPixelsToPut; pixelNum++ )
 			{
+				this->putPixel<width, height>( pixelArray, pixelNum );
+			}
+		}
+
+		// puts numPixels pixels starting at pixelStart. The partial bytes at either end are masked, and the whole bytes between are
+		// set with memset, or combined a word at a time for the other raster ops
+		template <unsigned int width, unsigned int height>
+		void putSpan (std::array<uint8_t, (width * height) / 8>& pixelArray, unsigned int pixelStart, unsigned int numPixels)
+		{
+			if ( numPixels == 0 || m_AValue == 0 )
+			{
+				return;
+			}
 #ifdef ROTATE_DISPLAY_180_DEGREES
-				pixelNum = fbNumPixels - 1 - pixelNum;
+			pixelStart = ( width * height ) - pixelStart - numPixels;
 #endif
-				unsigned int byteNum = std::floor( pixelNum / 8 );
-				unsigned int pixelIndex = 7 - (pixelNum % 8);
-				uint8_t bitmask = ( 1 << pixelIndex );
-				if ( m_MValue == true && m_AValue > 0 )
-				{
-					pixelArray[byteNum] = pixelArray[byteNum] | bitmask;
-				}
-				else if ( m_AValue > 0 )
-				{
-					pixelArray[byteNum] = pixelArray[byteNum] & ~(bitmask);
-				}
+			const unsigned int pixelEnd = pixelStart + numPixels;
+			const unsigned int firstByte = pixelStart / 8;
+			const unsigned int lastByte = ( pixelEnd - 1 ) / 8;
+			const uint8_t firstMask = 0xFF >> ( pixelStart % 8 );
+			const uint8_t lastMask = 0xFF << ( 7 - ((pixelEnd - 1) % 8) );
+
+			if ( firstByte == lastByte )
+			{
+				pixelArray[firstByte] = applyRasterOp( pixelArray[firstByte], static_cast<uint8_t>(firstMask & lastMask) );
+				return;
 			}
+
+			pixelArray[firstByte] = applyRasterOp( pixelArray[firstByte], firstMask );
+			this->putWholeBytes( &pixelArray[firstByte + 1], lastByte - firstByte - 1 );
+			pixelArray[lastByte] = applyRasterOp( pixelArray[lastByte], lastMask );
 		}
 
+		// puts the pixels whose bits are set in the numBytes masks, over the bytes starting at byteStart. This lets many short spans
+		// in a row be combined into one write, a word at a time, with words that have no bits set skipped
 		template <unsigned int width, unsigned int height>
-		void putPixelWithAlphaBlending (std::array<uint8_t, (width * height) / 8>& pixelArray, unsigned int pixelNum)
+		void putMaskedBytes (std::array<uint8_t, (width * height) / 8>& pixelArray, unsigned int byteStart, const uint8_t* masks,
+				unsigned int numBytes)
 		{
+			if ( m_AValue == 0 )
+			{
+				return;
+			}
 #ifdef ROTATE_DISPLAY_180_DEGREES
-			pixelNum = fbNumPixels - 1 - pixelNum;
-#endif
-			unsigned int byteNum = std::floor( pixelNum / 8 );
-			unsigned int pixelIndex = 7 - (pixelNum % 8);
-			uint8_t bitmask = ( 1 << pixelIndex );
-			if ( m_MValue == true && m_AValue > 0 )
+			// the bytes are stored in reverse, and so are the bits in each byte
+			for ( unsigned int byteNum = 0; byteNum < numBytes; byteNum++ )
+			{
+				if ( masks[byteNum] != 0 )
+				{
+					uint8_t& bits = pixelArray[((width * height) / 8) - 1 - byteStart - byteNum];
+					bits = applyRasterOp( bits, reverseBits(masks[byteNum]) );
+				}
+			}
+#else
+			// the frame buffer isn't necessarily word aligned, so words are loaded and stored with memcpy
+			uint8_t* bytes = &pixelArray[byteStart];
+			unsigned int byteNum = 0;
+			for ( ; byteNum + sizeof(uint32_t) <= numBytes; byteNum += sizeof(uint32_t) )
 			{
-				pixelArray[byteNum] = pixelArray[byteNum] | bitmask;
+				uint32_t mask;
+				std::memcpy( &mask, &masks[byteNum], sizeof(uint32_t) );
+				if ( mask != 0 )
+				{
+					uint32_t word;
+					std::memcpy( &word, &bytes[byteNum], sizeof(uint32_t) );
+					word = applyRasterOp( word, mask );
+					std::memcpy( &bytes[byteNum], &word, sizeof(uint32_t) );
+				}
 			}
-			else if ( m_AValue > 0 )
+			for ( ; byteNum < numBytes; byteNum++ )
 			{
-				pixelArray[byteNum] = pixelArray[byteNum] & ~(bitmask);
+				bytes[byteNum] = applyRasterOp( bytes[byteNum], masks[byteNum] );
 			}
+#endif
 		}
 
+		template <unsigned int width, unsigned int height>
+		void putPixelWithAlphaBlending (std::array<uint8_t, (width * height) / 8>& pixelArray, unsigned int pixelNum)
+		{
+			this->putPixel<width, height>( pixelArray, pixelNum );
+		}
+
+		// how pixels that are put are combined with the pixels already in the frame buffer
+		void setRasterOp (RASTER_OP rasterOp) { m_RasterOp = rasterOp; }
+		RASTER_OP getRasterOp() const { return m_RasterOp; }
+
 		template <unsigned int width, unsigned int height>
 		Color getPixel (std::array<uint8_t, (width * height) / 8>& pixelArray, unsigned int pixelNum) const
 		{
@@ -145,7 +222,7 @@ class ColorProfileMonochrome : public ColorProfileCommon
 
 			color.m_IsMonochrome = true;
 
-			unsigned int byteNum = std::floor( pixelNum / 8 );
+			unsigned int byteNum = pixelNum / 8;
 			unsigned int pixelIndex = 7 - (pixelNum % 8);
 			uint8_t bitmask = ( 1 << pixelIndex );
 
@@ -179,7 +256,7 @@ class ColorProfileMonochrome : public ColorProfileCommon
 
 			color.m_IsMonochrome = true;
 
-			unsigned int byteNum = std::floor( pixelNum / 8 );
+			unsigned int byteNum = pixelNum / 8;
 			unsigned int pixelIndex = 7 - (pixelNum % 8);
 			uint8_t bitmask = ( 1 << pixelIndex );
 
@@ -206,6 +283,58 @@ class ColorProfileMonochrome : public ColorProfileCommon
 
 			return color;
 		}
+
+	private:
+		RASTER_OP m_RasterOp = RASTER_OP::COPY;
+
+		// combines the current color with the bits that are set in mask
+		template <typename T>
+		inline T applyRasterOp (T bits, T mask) const
+		{
+			const T value = ( m_MValue ) ? mask : 0;
+			switch ( m_RasterOp )
+			{
+				case RASTER_OP::OR:
+					return bits | value;
+				case RASTER_OP::AND:
+					return bits & ( value | static_cast<T>(~mask) );
+				case RASTER_OP::XOR:
+					return bits ^ value;
+				case RASTER_OP::COPY:
+				default:
+					return ( bits & static_cast<T>(~mask) ) | value;
+			}
+		}
+
+		static inline uint8_t reverseBits (uint8_t bits)
+		{
+			bits = static_cast<uint8_t>( ((bits & 0xF0) >> 4) | ((bits & 0x0F) << 4) );
+			bits = static_cast<uint8_t>( ((bits & 0xCC) >> 2) | ((bits & 0x33) << 2) );
+			return static_cast<uint8_t>( ((bits & 0xAA) >> 1) | ((bits & 0x55) << 1) );
+		}
+
+		inline void putWholeBytes (uint8_t* bytes, unsigned int numBytes) const
+		{
+			if ( m_RasterOp == RASTER_OP::COPY )
+			{
+				std::memset( bytes, (m_MValue) ? 0xFF : 0x00, numBytes );
+				return;
+			}
+
+			// the frame buffer isn't necessarily word aligned, so words are loaded and stored with memcpy
+			unsigned int byteNum = 0;
+			for ( ; byteNum + sizeof(uint32_t) <= numBytes; byteNum += sizeof(uint32_t) )
+			{
+				uint32_t word;
+				std::memcpy( &word, &bytes[byteNum], sizeof(uint32_t) );
+				word = applyRasterOp( word, static_cast<uint32_t>(0xFFFFFFFF) );
+				std::memcpy( &bytes[byteNum], &word, sizeof(uint32_t) );
+			}
+			for ( ; byteNum < numBytes; byteNum++ )
+			{
+				bytes[byteNum] = applyRasterOp( bytes[byteNum], static_cast<uint8_t>(0xFF) );
+			}
+		}
 };
 
 template <CP_FORMAT format>
@@ -245,6 +374,37 @@ class ColorProfileRGB : public ColorProfileCommon
 			}
 		}
 
+		// puts numPixels pixels starting at pixelStart
+		template <unsigned int width, unsigned int height>
+		void putSpan (std::array<uint8_t, width * height * 3>& pixelArray, unsigned int pixelStart, unsigned int numPixels)
+		{
+			if ( numPixels == 0 )
+			{
+				return;
+			}
+#ifdef ROTATE_DISPLAY_180_DEGREES
+			pixelStart = ( width * height ) - pixelStart - numPixels;
+#endif
+			const uint8_t pixel[3] = { m_RValue, m_GValue, m_BValue };
+			uint8_t* bytes = &pixelArray[pixelStart * 3];
+
+			if ( pixel[0] == pixel[1] && pixel[0] == pixel[2] )
+			{
+				std::memset( bytes, pixel[0], numPixels * 3 );
+			}
+			else if ( numPixels < m_MinPatternSpanPixels )
+			{
+				for ( unsigned int byteNum = 0; byteNum < numPixels * 3; byteNum += 3 )
+				{
+					std::memcpy( &bytes[byteNum], pixel, 3 );
+				}
+			}
+			else
+			{
+				putPattern( bytes, pixel, 3, numPixels * 3 );
+			}
+		}
+
 		template <unsigned int width, unsigned int height>
 		void putPixelWithAlphaBlending (std::array<uint8_t, width * height * 3>& pixelArray, unsigned int pixelNum)
 		{
@@ -330,6 +490,37 @@ class ColorProfileBGR : public ColorProfileCommon
 			}
 		}
 
+		// puts numPixels pixels starting at pixelStart
+		template <unsigned int width, unsigned int height>
+		void putSpan (std::array<uint8_t, width * height * 3>& pixelArray, unsigned int pixelStart, unsigned int numPixels)
+		{
+			if ( numPixels == 0 )
+			{
+				return;
+			}
+#ifdef ROTATE_DISPLAY_180_DEGREES
+			pixelStart = ( width * height ) - pixelStart - numPixels;
+#endif
+			const uint8_t pixel[3] = { m_BValue, m_GValue, m_RValue };
+			uint8_t* bytes = &pixelArray[pixelStart * 3];
+
+			if ( pixel[0] == pixel[1] && pixel[0] == pixel[2] )
+			{
+				std::memset( bytes, pixel[0], numPixels * 3 );
+			}
+			else if ( numPixels < m_MinPatternSpanPixels )
+			{
+				for ( unsigned int byteNum = 0; byteNum < numPixels * 3; byteNum += 3 )
+				{
+					std::memcpy( &bytes[byteNum], pixel, 3 );
+				}
+			}
+			else
+			{
+				putPattern( bytes, pixel, 3, numPixels * 3 );
+			}
+		}
+
 		template <unsigned int width, unsigned int height>
 		void putPixelWithAlphaBlending (std::array<uint8_t, width * height * 3>& pixelArray, unsigned int pixelNum)
 		{
@@ -417,8 +608,39 @@ class ColorProfileRGBA : public ColorProfileCommon
 			}
 		}
 
+		// puts numPixels pixels starting at pixelStart
 		template <unsigned int width, unsigned int height>
-		void putPixelWithAlphaBlending (std::array<uint8_t, width * height * 3>& pixelArray, unsigned int pixelNum)
+		void putSpan (std::array<uint8_t, width * height * 4>& pixelArray, unsigned int pixelStart, unsigned int numPixels)
+		{
+			if ( numPixels == 0 )
+			{
+				return;
+			}
+#ifdef ROTATE_DISPLAY_180_DEGREES
+			pixelStart = ( width * height ) - pixelStart - numPixels;
+#endif
+			const uint8_t pixel[4] = { m_RValue, m_GValue, m_BValue, m_AValue };
+			uint8_t* bytes = &pixelArray[pixelStart * 4];
+
+			if ( pixel[0] == pixel[1] && pixel[0] == pixel[2] && pixel[0] == pixel[3] )
+			{
+				std::memset( bytes, pixel[0], numPixels * 4 );
+			}
+			else if ( numPixels < m_MinPatternSpanPixels )
+			{
+				for ( unsigned int byteNum = 0; byteNum < numPixels * 4; byteNum += 4 )
+				{
+					std::memcpy( &bytes[byteNum], pixel, 4 );
+				}
+			}
+			else
+			{
+				putPattern( bytes, pixel, 4, numPixels * 4 );
+			}
+		}
+
+		template <unsigned int width, unsigned int height>
+		void putPixelWithAlphaBlending (std::array<uint8_t, width * height * 4>& pixelArray, unsigned int pixelNum)
 		{
 #ifdef ROTATE_DISPLAY_180_DEGREES
 			pixelNum = fbNumPixels - 1 - pixelNum;
@@ -428,7 +650,7 @@ class ColorProfileRGBA : public ColorProfileCommon
 			pixelArray[(pixelNum * 4) + 0] = 255 * newColor.m_R; // Red
 			pixelArray[(pixelNum * 4) + 1] = 255 * newColor.m_G; // Green
 			pixelArray[(pixelNum * 4) + 2] = 255 * newColor.m_B; // Blue
-			pixelArray[(pixelNum * 4) + 3] = 255 * newColor.m_B; // Blue
+			pixelArray[(pixelNum * 4) + 3] = 255 * newColor.m_A; // Alpha
 		}
 
 		template <unsigned int width, unsigned int height>
@@ -0,0 +1,61 @@
+#ifndef DAMAGELIST_HPP
+#define DAMAGELIST_HPP
+
+/**************************************************************************
+ * The DamageList class holds the areas of a frame buffer that changed as
+ * at most DAMAGE_LIST_MAX_RECTS rectangles, so that a display which is
+ * updated over a slow bus only needs to be sent those areas. Rectangles
+ * are merged whenever the merged rectangle covers no more pixels than
+ * the two did apart, and once the list is full a new rectangle is
+ * merged into whichever rectangle grows the least. So the list always
+ * covers everything added to it, but may cover more.
+**************************************************************************/
+
+#include <array>
+
+#ifdef DAMAGE_LIST_NUM_RECTS
+constexpr unsigned int DAMAGE_LIST_MAX_RECTS = DAMAGE_LIST_NUM_RECTS;
+#else
+constexpr unsigned int DAMAGE_LIST_MAX_RECTS = 8;
+#endif
+
+// in pixels, the max coordinates are one past the last pixel of the rect
+struct DamageRect
+{
+	unsigned int xMin;
+	unsigned int yMin;
+	unsigned int xMaxExclusive;
+	unsigned int yMaxExclusive;
+
+	unsigned int getArea() const { return ( xMaxExclusive - xMin ) * ( yMaxExclusive - yMin ); }
+};
+
+class DamageList
+{
+	public:
+		DamageList();
+
+		// empty rects are ignored
+		void addRect (const DamageRect& rect);
+		void addList (const DamageList& list);
+		void clear() { m_NumRects = 0; }
+
+		bool isEmpty() const { return m_NumRects == 0; }
+		unsigned int getNumRects() const { return m_NumRects; }
+		const DamageRect& getRect (unsigned int rectNum) const { return m_Rects[rectNum]; }
+		// the number of pixels covered by the rects, which doesn't count pixels twice since rects never overlap
+		unsigned int getArea() const;
+
+		const DamageRect* begin() const { return m_Rects.data(); }
+		const DamageRect* end() const { return m_Rects.data() + m_NumRects; }
+
+	private:
+		std::array<DamageRect, DAMAGE_LIST_MAX_RECTS> 	m_Rects;
+		unsigned int 					m_NumRects;
+
+		static DamageRect getUnion (const DamageRect& rect1, const DamageRect& rect2);
+		static bool overlaps (const DamageRect& rect1, const DamageRect& rect2);
+		void removeRect (unsigned int rectNum);
+};
+
+#endif // DAMAGELIST_HPP
@@ -0,0 +1,287 @@
+#ifndef DEPTHBUFFER_HPP
+#define DEPTHBUFFER_HPP
+
+/**************************************************************************
+ * The DepthBuffer class holds the per pixel depth values used by the
+ * software renderer, along with a coarse hierarchy of the max depth in
+ * each tile of TILE_SIZE x TILE_SIZE pixels. A fragment only passes the
+ * depth test if its depth is <= the stored depth, so a triangle or span
+ * whose min depth is greater than the max depth of the tiles it covers
+ * can be rejected without interpolating anything or calling a shader.
+ * The tile max depths are only ever too large, never too small, until
+ * updateTiles is called to recompute the tiles marked dirty.
+ *
+ * Clearing is lazy, each tile is only filled with the clear depth when
+ * resolveTile is called for it before its first depth test, so tiles
+ * that nothing is drawn to are never written.
+ *
+ * Depths can be stored as floats, or as 16 or 24 bit normalized values
+ * to save memory and bandwidth. The format used by the software renderer
+ * is chosen by defining DEPTH_BUFFER_16BIT or DEPTH_BUFFER_24BIT.
+**************************************************************************/
+
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+
+enum class DEPTH_FORMAT
+{
+	FLOAT_32BIT,
+	UNORM_16BIT,
+	UNORM_24BIT // packed into 3 bytes per pixel
+};
+
+#if defined(DEPTH_BUFFER_16BIT)
+constexpr DEPTH_FORMAT DEFAULT_DEPTH_FORMAT = DEPTH_FORMAT::UNORM_16BIT;
+#elif defined(DEPTH_BUFFER_24BIT)
+constexpr DEPTH_FORMAT DEFAULT_DEPTH_FORMAT = DEPTH_FORMAT::UNORM_24BIT;
+#else
+constexpr DEPTH_FORMAT DEFAULT_DEPTH_FORMAT = DEPTH_FORMAT::FLOAT_32BIT;
+#endif
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat = DEFAULT_DEPTH_FORMAT>
+class DepthBuffer
+{
+	public:
+		static constexpr unsigned int TILE_SIZE = 8;
+		static constexpr unsigned int NUM_TILES_X = ( width  + TILE_SIZE - 1 ) / TILE_SIZE;
+		static constexpr unsigned int NUM_TILES_Y = ( height + TILE_SIZE - 1 ) / TILE_SIZE;
+		static constexpr DEPTH_FORMAT FORMAT = depthFormat;
+
+		// the type depths are stored and compared as. The normalized formats map the -1.0f -> 1.0f depth range the clipper lets
+		// through to 0 -> MAX_NORMALIZED_VALUE, clamping anything outside of it
+		using DepthValue = typename std::conditional<depthFormat == DEPTH_FORMAT::FLOAT_32BIT, float,
+					typename std::conditional<depthFormat == DEPTH_FORMAT::UNORM_16BIT, uint16_t, uint32_t>::type>::type;
+		static constexpr uint32_t MAX_NORMALIZED_VALUE = ( depthFormat == DEPTH_FORMAT::UNORM_16BIT ) ? 0xFFFF : 0xFFFFFF;
+
+		DepthBuffer();
+
+		static inline DepthValue toDepthValue (float depth);
+		static inline float toFloat (DepthValue depthValue);
+
+		inline DepthValue get (unsigned int pixel) const;
+		inline void set (unsigned int pixel, DepthValue depthValue);
+		// unlike get, this also works for pixels in tiles that haven't been resolved since the last clear
+		float getDepth (unsigned int pixel) const;
+		// only for the float format, so that batches of depths can be compared directly
+		const float* getFloatDepths (unsigned int pixel) const { return &m_Depths[pixel]; }
+
+		void clear (float depth);
+		// must be called before reading or writing pixels in the tile after a clear
+		void resolveTile (unsigned int tileX, unsigned int tileY)
+		{
+			if ( m_TileClearPending[(tileY * NUM_TILES_X) + tileX] )
+			{
+				this->fillTile( tileX, tileY );
+			}
+		}
+
+		DepthValue getTileMaxDepth (unsigned int tileX, unsigned int tileY) const { return m_TileMaxDepths[(tileY * NUM_TILES_X) + tileX]; }
+		// must be called after writing to a pixel in the tile, so that updateTiles knows to recompute it
+		void markTileDirty (unsigned int tileX, unsigned int tileY) { m_TileDirty[(tileY * NUM_TILES_X) + tileX] = true; }
+
+		// returns true if nothing with a depth of at least minDepth can pass the depth test in the given tile
+		bool isTileOccluded (unsigned int tileX, unsigned int tileY, float minDepth) const
+		{
+			return toDepthValue( minDepth ) > getTileMaxDepth( tileX, tileY );
+		}
+		// returns true if nothing with a depth of at least minDepth can pass the depth test in the given pixel rect
+		bool isOccluded (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive, float minDepth) const;
+		// recomputes the max depth of the dirty tiles that overlap the given pixel rect
+		void updateTiles (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive);
+
+	private:
+		static constexpr unsigned int BYTES_PER_PACKED_VALUE = 3;
+		using StorageType = typename std::conditional<depthFormat == DEPTH_FORMAT::UNORM_24BIT, uint8_t, DepthValue>::type;
+		static constexpr unsigned int STORAGE_PER_PIXEL = ( depthFormat == DEPTH_FORMAT::UNORM_24BIT ) ? BYTES_PER_PACKED_VALUE : 1;
+
+		std::array<StorageType, width * height * STORAGE_PER_PIXEL> 	m_Depths;
+		std::array<DepthValue, NUM_TILES_X * NUM_TILES_Y> 		m_TileMaxDepths;
+		std::array<bool, NUM_TILES_X * NUM_TILES_Y> 			m_TileDirty;
+		std::array<bool, NUM_TILES_X * NUM_TILES_Y> 			m_TileClearPending;
+		DepthValue 							m_ClearValue;
+
+		void fillTile (unsigned int tileX, unsigned int tileY);
+};
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+DepthBuffer<width, height, depthFormat>::DepthBuffer()
+{
+	// the depths aren't known until the first clear, so don't reject anything until then
+	if constexpr ( depthFormat == DEPTH_FORMAT::FLOAT_32BIT )
+	{
+		m_TileMaxDepths.fill( std::numeric_limits<float>::infinity() );
+	}
+	else
+	{
+		m_TileMaxDepths.fill( MAX_NORMALIZED_VALUE );
+	}
+	m_TileDirty.fill( false );
+	m_TileClearPending.fill( false );
+	m_ClearValue = m_TileMaxDepths[0];
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+typename DepthBuffer<width, height, depthFormat>::DepthValue DepthBuffer<width, height, depthFormat>::toDepthValue (float depth)
+{
+	if constexpr ( depthFormat == DEPTH_FORMAT::FLOAT_32BIT )
+	{
+		return depth;
+	}
+	else
+	{
+		// for the 24 bit format, rounding near 1.0f can go one past the max since floats only have 24 bits of precision
+		const float normalized = std::min( std::max((depth * 0.5f) + 0.5f, 0.0f), 1.0f );
+		const uint32_t depthValue = static_cast<uint32_t>( (normalized * static_cast<float>(MAX_NORMALIZED_VALUE)) + 0.5f );
+		return static_cast<DepthValue>( std::min(depthValue, MAX_NORMALIZED_VALUE) );
+	}
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+float DepthBuffer<width, height, depthFormat>::toFloat (DepthValue depthValue)
+{
+	if constexpr ( depthFormat == DEPTH_FORMAT::FLOAT_32BIT )
+	{
+		return depthValue;
+	}
+	else
+	{
+		return ( (static_cast<float>(depthValue) / static_cast<float>(MAX_NORMALIZED_VALUE)) * 2.0f ) - 1.0f;
+	}
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+typename DepthBuffer<width, height, depthFormat>::DepthValue DepthBuffer<width, height, depthFormat>::get (unsigned int pixel) const
+{
+	if constexpr ( depthFormat == DEPTH_FORMAT::UNORM_24BIT )
+	{
+		const unsigned int byteIndex = pixel * BYTES_PER_PACKED_VALUE;
+		return static_cast<uint32_t>( m_Depths[byteIndex] )
+			| ( static_cast<uint32_t>(m_Depths[byteIndex + 1]) << 8 )
+			| ( static_cast<uint32_t>(m_Depths[byteIndex + 2]) << 16 );
+	}
+	else
+	{
+		return m_Depths[pixel];
+	}
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+void DepthBuffer<width, height, depthFormat>::set (unsigned int pixel, DepthValue depthValue)
+{
+	if constexpr ( depthFormat == DEPTH_FORMAT::UNORM_24BIT )
+	{
+		const unsigned int byteIndex = pixel * BYTES_PER_PACKED_VALUE;
+		m_Depths[byteIndex]     = static_cast<uint8_t>( depthValue );
+		m_Depths[byteIndex + 1] = static_cast<uint8_t>( depthValue >> 8 );
+		m_Depths[byteIndex + 2] = static_cast<uint8_t>( depthValue >> 16 );
+	}
+	else
+	{
+		m_Depths[pixel] = depthValue;
+	}
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+float DepthBuffer<width, height, depthFormat>::getDepth (unsigned int pixel) const
+{
+	const unsigned int tileNum = ( ((pixel / width) / TILE_SIZE) * NUM_TILES_X ) + ( (pixel % width) / TILE_SIZE );
+	return toFloat( (m_TileClearPending[tileNum]) ? m_ClearValue : this->get(pixel) );
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+void DepthBuffer<width, height, depthFormat>::clear (float depth)
+{
+	m_ClearValue = toDepthValue( depth );
+	m_TileMaxDepths.fill( m_ClearValue );
+	m_TileDirty.fill( false );
+	m_TileClearPending.fill( true );
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+void DepthBuffer<width, height, depthFormat>::fillTile (unsigned int tileX, unsigned int tileY)
+{
+	const unsigned int pixelXEnd = std::min( (tileX + 1) * TILE_SIZE, width );
+	const unsigned int pixelYEnd = std::min( (tileY + 1) * TILE_SIZE, height );
+	for ( unsigned int pixelY = tileY * TILE_SIZE; pixelY < pixelYEnd; pixelY++ )
+	{
+		for ( unsigned int pixelX = tileX * TILE_SIZE; pixelX < pixelXEnd; pixelX++ )
+		{
+			this->set( (pixelY * width) + pixelX, m_ClearValue );
+		}
+	}
+
+	m_TileClearPending[(tileY * NUM_TILES_X) + tileX] = false;
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+bool DepthBuffer<width, height, depthFormat>::isOccluded (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive, float minDepth) const
+{
+	if ( xMin >= xMaxExclusive || yMin >= yMaxExclusive )
+	{
+		return true;
+	}
+
+	const DepthValue minDepthValue = toDepthValue( minDepth );
+	const unsigned int tileXStart = xMin / TILE_SIZE;
+	const unsigned int tileXEnd   = ( xMaxExclusive - 1 ) / TILE_SIZE;
+	const unsigned int tileYStart = yMin / TILE_SIZE;
+	const unsigned int tileYEnd   = ( yMaxExclusive - 1 ) / TILE_SIZE;
+
+	for ( unsigned int tileY = tileYStart; tileY <= tileYEnd; tileY++ )
+	{
+		for ( unsigned int tileX = tileXStart; tileX <= tileXEnd; tileX++ )
+		{
+			if ( minDepthValue <= m_TileMaxDepths[(tileY * NUM_TILES_X) + tileX] )
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template <unsigned int width, unsigned int height, DEPTH_FORMAT depthFormat>
+void DepthBuffer<width, height, depthFormat>::updateTiles (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive)
+{
+	if ( xMin >= xMaxExclusive || yMin >= yMaxExclusive )
+	{
+		return;
+	}
+
+	const unsigned int tileXStart = xMin / TILE_SIZE;
+	const unsigned int tileXEnd   = ( xMaxExclusive - 1 ) / TILE_SIZE;
+	const unsigned int tileYStart = yMin / TILE_SIZE;
+	const unsigned int tileYEnd   = ( yMaxExclusive - 1 ) / TILE_SIZE;
+
+	for ( unsigned int tileY = tileYStart; tileY <= tileYEnd; tileY++ )
+	{
+		for ( unsigned int tileX = tileXStart; tileX <= tileXEnd; tileX++ )
+		{
+			const unsigned int tileNum = ( tileY * NUM_TILES_X ) + tileX;
+			if ( ! m_TileDirty[tileNum] )
+			{
+				continue;
+			}
+
+			const unsigned int pixelXEnd = std::min( (tileX + 1) * TILE_SIZE, width );
+			const unsigned int pixelYEnd = std::min( (tileY + 1) * TILE_SIZE, height );
+			DepthValue maxDepth = std::numeric_limits<DepthValue>::lowest();
+			for ( unsigned int pixelY = tileY * TILE_SIZE; pixelY < pixelYEnd; pixelY++ )
+			{
+				for ( unsigned int pixelX = tileX * TILE_SIZE; pixelX < pixelXEnd; pixelX++ )
+				{
+					maxDepth = std::max( maxDepth, this->get((pixelY * width) + pixelX) );
+				}
+			}
+
+			m_TileMaxDepths[tileNum] = maxDepth;
+			m_TileDirty[tileNum] = false;
+		}
+	}
+}
+
+#endif // DEPTHBUFFER_HPP
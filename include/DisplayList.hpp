@@ -0,0 +1,698 @@
+#ifndef DISPLAYLIST_HPP
+#define DISPLAYLIST_HPP
+
+/**************************************************************************
+ * The DisplayList class records calls to the 2D drawing functions of
+ * IGraphics into a compact command buffer, so that they can be replayed
+ * into any Graphics object later, as many times as needed. A static UI
+ * can be recorded once and replayed every frame, instead of running the
+ * code that decides what to draw every frame.
+ *
+ * Coordinates are recorded as they are given, so a display list doesn't
+ * depend on the size or format of the frame buffer it's replayed into.
+ * Commands that would be entirely off of the screen are culled when
+ * replaying. optimize() can be called after recording to merge and drop
+ * commands, assuming that drawing replaces the pixels under it.
+ *
+ * Text is copied when recorded, but fonts and sprites are only pointed
+ * to, so they have to outlive the display list. Draw code that should
+ * be able to record into a display list can be written as a template on
+ * the type of the graphics object, since DisplayList has the same
+ * drawing functions as IGraphics.
+**************************************************************************/
+
+#include "IGraphics.hpp"
+#include "Font.hpp"
+#include "Sprite.hpp"
+#include "DamageList.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum class DISPLAY_COMMAND : uint8_t
+{
+	SET_COLOR_RGB,
+	SET_COLOR_RGBA,
+	SET_COLOR_MONOCHROME,
+	SET_FONT,
+	FILL,
+	LINE,
+	POLYLINE,
+	BOX,
+	BOX_FILLED,
+	TRIANGLE,
+	TRIANGLE_FILLED,
+	QUAD,
+	QUAD_FILLED,
+	CIRCLE,
+	CIRCLE_FILLED,
+	ELLIPSE_FILLED,
+	TEXT,
+	TEXT_CACHED,
+	SPRITE_MONOCHROME,
+	SPRITE_RGBA,
+	SPRITE_RGB,
+	SPRITE_BGR
+};
+
+struct DisplayCommand
+{
+	DISPLAY_COMMAND 	m_Type;
+	bool 			m_Closed; // only for polylines
+	uint32_t 		m_ArgsStart; // the index of the first float argument
+	uint32_t 		m_NumArgs;
+	uint32_t 		m_DataIndex; // the index of the text for text, or of the pointer for fonts and sprites
+};
+
+template <RENDER_API api>
+class DisplayList
+{
+	public:
+		DisplayList() {}
+
+		void setColor (float r, float g, float b) { this->addCommand( DISPLAY_COMMAND::SET_COLOR_RGB, {r, g, b} ); }
+		void setColor (float r, float g, float b, float a) { this->addCommand( DISPLAY_COMMAND::SET_COLOR_RGBA, {r, g, b, a} ); }
+		void setColor (bool val) { this->addCommand( DISPLAY_COMMAND::SET_COLOR_MONOCHROME, {(val) ? 1.0f : 0.0f} ); }
+
+		void setFont (Font* font) { this->addPointerCommand( DISPLAY_COMMAND::SET_FONT, font ); }
+
+		void fill() { this->addCommand( DISPLAY_COMMAND::FILL, {} ); }
+		void drawLine (float xStart, float yStart, float xEnd, float yEnd)
+		{
+			this->addCommand( DISPLAY_COMMAND::LINE, {xStart, yStart, xEnd, yEnd} );
+		}
+		void drawPolyline (const float* points, unsigned int numPoints, bool closed = false);
+		void drawBox (float xStart, float yStart, float xEnd, float yEnd)
+		{
+			this->addCommand( DISPLAY_COMMAND::BOX, {xStart, yStart, xEnd, yEnd} );
+		}
+		void drawBoxFilled (float xStart, float yStart, float xEnd, float yEnd)
+		{
+			this->addCommand( DISPLAY_COMMAND::BOX_FILLED, {xStart, yStart, xEnd, yEnd} );
+		}
+		void drawTriangle (float x1, float y1, float x2, float y2, float x3, float y3)
+		{
+			this->addCommand( DISPLAY_COMMAND::TRIANGLE, {x1, y1, x2, y2, x3, y3} );
+		}
+		void drawTriangleFilled (float x1, float y1, float x2, float y2, float x3, float y3)
+		{
+			this->addCommand( DISPLAY_COMMAND::TRIANGLE_FILLED, {x1, y1, x2, y2, x3, y3} );
+		}
+		void drawQuad (float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4)
+		{
+			this->addCommand( DISPLAY_COMMAND::QUAD, {x1, y1, x2, y2, x3, y3, x4, y4} );
+		}
+		void drawQuadFilled (float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4)
+		{
+			this->addCommand( DISPLAY_COMMAND::QUAD_FILLED, {x1, y1, x2, y2, x3, y3, x4, y4} );
+		}
+		void drawCircle (float originX, float originY, float radius)
+		{
+			this->addCommand( DISPLAY_COMMAND::CIRCLE, {originX, originY, radius} );
+		}
+		void drawCircleFilled (float originX, float originY, float radius)
+		{
+			this->addCommand( DISPLAY_COMMAND::CIRCLE_FILLED, {originX, originY, radius} );
+		}
+		void drawEllipseFilled (float originX, float originY, float radiusX, float radiusY)
+		{
+			this->addCommand( DISPLAY_COMMAND::ELLIPSE_FILLED, {originX, originY, radiusX, radiusY} );
+		}
+		void drawText (float xStart, float yStart, const char* text, float scaleFactor)
+		{
+			this->addTextCommand( DISPLAY_COMMAND::TEXT, xStart, yStart, text, scaleFactor );
+		}
+		void drawTextCached (float xStart, float yStart, const char* text, float scaleFactor)
+		{
+			this->addTextCommand( DISPLAY_COMMAND::TEXT_CACHED, xStart, yStart, text, scaleFactor );
+		}
+
+		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::MONOCHROME_1BIT, api>& sprite)
+		{
+			this->addPointerCommand( DISPLAY_COMMAND::SPRITE_MONOCHROME, &sprite, {xStart, yStart} );
+		}
+		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::RGBA_32BIT, api>& sprite)
+		{
+			this->addPointerCommand( DISPLAY_COMMAND::SPRITE_RGBA, &sprite, {xStart, yStart} );
+		}
+		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::RGB_24BIT, api>& sprite)
+		{
+			this->addPointerCommand( DISPLAY_COMMAND::SPRITE_RGB, &sprite, {xStart, yStart} );
+		}
+		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::BGR_24BIT, api>& sprite)
+		{
+			this->addPointerCommand( DISPLAY_COMMAND::SPRITE_BGR, &sprite, {xStart, yStart} );
+		}
+
+		// draws every command that isn't entirely off of the screen into graphics. This is const, so render threads can replay the
+		// same display list at the same time
+		template <unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
+		void replay (IGraphics<width, height, format, api, include3D, shaderPassDataSize>& graphics) const;
+
+		// drops drawing commands that come before the last fill and colors and fonts that are set without being drawn with, and
+		// merges consecutive filled boxes that line up into one box or are inside of the box before them. This assumes that
+		// drawing replaces the pixels under it, so it shouldn't be used for lists replayed with monochrome raster ops other than
+		// COPY
+		void optimize();
+
+		// keeps the memory, so that recording again doesn't allocate
+		void clear();
+
+		// the pixels the commands can draw to in a width x height frame buffer, or false if none of them draw on the screen. Text is
+		// measured with font until the list sets a font of its own
+		template <unsigned int width, unsigned int height>
+		bool getPixelBounds (const Font* font, DamageRect& boundsOut) const;
+
+		bool isEmpty() const { return m_Commands.empty(); }
+		unsigned int getNumCommands() const { return m_Commands.size(); }
+
+	private:
+		// how far outside of the screen (in pixels) a command can reach before it's culled, for rounding in the rasterizers
+		static constexpr float m_CullSlack = 2.0f;
+
+		std::vector<DisplayCommand> 	m_Commands;
+		std::vector<float> 		m_Args;
+		std::vector<char> 		m_Text;
+		std::vector<const void*> 	m_Pointers;
+
+		inline void addCommand (DISPLAY_COMMAND type, std::initializer_list<float> args);
+		inline void addPointerCommand (DISPLAY_COMMAND type, const void* pointer, std::initializer_list<float> args = {});
+		inline void addTextCommand (DISPLAY_COMMAND type, float xStart, float yStart, const char* text, float scaleFactor);
+
+		static inline bool isStateCommand (DISPLAY_COMMAND type);
+		// true if the commands set the same color, or both set the same font
+		inline bool isSameState (const DisplayCommand& command1, const DisplayCommand& command2) const;
+		// if box is next to or inside of previousBox, previousBox is grown to cover both and true is returned
+		static inline bool mergeBoxes (float* previousBox, const float* box);
+
+		template <unsigned int width, unsigned int height>
+		inline bool isOffScreen (const DisplayCommand& command, const Font* font) const;
+		// the rect in pixels that the command can draw to, or false if the command doesn't draw
+		template <unsigned int width, unsigned int height>
+		inline bool getCommandBounds (const DisplayCommand& command, const Font* font, float& xMin, float& yMin, float& xMax,
+						float& yMax) const;
+		template <unsigned int width, unsigned int height, CP_FORMAT spriteFormat>
+		static inline void getSpriteBounds (const Sprite<spriteFormat, api>& sprite, float xStart, float yStart, float& xMin,
+							float& yMin, float& xMax, float& yMax);
+};
+
+template <RENDER_API api>
+void DisplayList<api>::drawPolyline (const float* points, unsigned int numPoints, bool closed)
+{
+	const DisplayCommand command{ DISPLAY_COMMAND::POLYLINE, closed, static_cast<uint32_t>(m_Args.size()), numPoints * 2, 0 };
+	m_Commands.push_back( command );
+	m_Args.insert( m_Args.end(), points, points + (numPoints * 2) );
+}
+
+template <RENDER_API api>
+inline void DisplayList<api>::addCommand (DISPLAY_COMMAND type, std::initializer_list<float> args)
+{
+	const DisplayCommand command{ type, false, static_cast<uint32_t>(m_Args.size()), static_cast<uint32_t>(args.size()), 0 };
+	m_Commands.push_back( command );
+	m_Args.insert( m_Args.end(), args );
+}
+
+template <RENDER_API api>
+inline void DisplayList<api>::addPointerCommand (DISPLAY_COMMAND type, const void* pointer, std::initializer_list<float> args)
+{
+	const DisplayCommand command{ type, false, static_cast<uint32_t>(m_Args.size()), static_cast<uint32_t>(args.size()),
+					static_cast<uint32_t>(m_Pointers.size()) };
+	m_Commands.push_back( command );
+	m_Args.insert( m_Args.end(), args );
+	m_Pointers.push_back( pointer );
+}
+
+template <RENDER_API api>
+inline void DisplayList<api>::addTextCommand (DISPLAY_COMMAND type, float xStart, float yStart, const char* text, float scaleFactor)
+{
+	const DisplayCommand command{ type, false, static_cast<uint32_t>(m_Args.size()), 3, static_cast<uint32_t>(m_Text.size()) };
+	m_Commands.push_back( command );
+	m_Args.insert( m_Args.end(), {xStart, yStart, scaleFactor} );
+	m_Text.insert( m_Text.end(), text, text + std::strlen(text) + 1 );
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
+void DisplayList<api>::replay (IGraphics<width, height, format, api, include3D, shaderPassDataSize>& graphics) const
+{
+	// the font is needed to know how far text reaches
+	const Font* font = graphics.getFont();
+
+	for ( const DisplayCommand& command : m_Commands )
+	{
+		const float* args = &m_Args[command.m_ArgsStart];
+		if ( ! this->isStateCommand(command.m_Type) && this->isOffScreen<width, height>(command, font) )
+		{
+			continue;
+		}
+
+		switch ( command.m_Type )
+		{
+			case DISPLAY_COMMAND::SET_COLOR_RGB:
+				graphics.setColor( args[0], args[1], args[2] );
+				break;
+			case DISPLAY_COMMAND::SET_COLOR_RGBA:
+				graphics.setColor( args[0], args[1], args[2], args[3] );
+				break;
+			case DISPLAY_COMMAND::SET_COLOR_MONOCHROME:
+				graphics.setColor( args[0] != 0.0f );
+				break;
+			case DISPLAY_COMMAND::SET_FONT:
+				font = static_cast<const Font*>( m_Pointers[command.m_DataIndex] );
+				graphics.setFont( const_cast<Font*>(font) );
+				break;
+			case DISPLAY_COMMAND::FILL:
+				graphics.fill();
+				break;
+			case DISPLAY_COMMAND::LINE:
+				graphics.drawLine( args[0], args[1], args[2], args[3] );
+				break;
+			case DISPLAY_COMMAND::POLYLINE:
+				graphics.drawPolyline( args, command.m_NumArgs / 2, command.m_Closed );
+				break;
+			case DISPLAY_COMMAND::BOX:
+				graphics.drawBox( args[0], args[1], args[2], args[3] );
+				break;
+			case DISPLAY_COMMAND::BOX_FILLED:
+				graphics.drawBoxFilled( args[0], args[1], args[2], args[3] );
+				break;
+			case DISPLAY_COMMAND::TRIANGLE:
+				graphics.drawTriangle( args[0], args[1], args[2], args[3], args[4], args[5] );
+				break;
+			case DISPLAY_COMMAND::TRIANGLE_FILLED:
+				graphics.drawTriangleFilled( args[0], args[1], args[2], args[3], args[4], args[5] );
+				break;
+			case DISPLAY_COMMAND::QUAD:
+				graphics.drawQuad( args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7] );
+				break;
+			case DISPLAY_COMMAND::QUAD_FILLED:
+				graphics.drawQuadFilled( args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7] );
+				break;
+			case DISPLAY_COMMAND::CIRCLE:
+				graphics.drawCircle( args[0], args[1], args[2] );
+				break;
+			case DISPLAY_COMMAND::CIRCLE_FILLED:
+				graphics.drawCircleFilled( args[0], args[1], args[2] );
+				break;
+			case DISPLAY_COMMAND::ELLIPSE_FILLED:
+				graphics.drawEllipseFilled( args[0], args[1], args[2], args[3] );
+				break;
+			case DISPLAY_COMMAND::TEXT:
+				graphics.drawText( args[0], args[1], &m_Text[command.m_DataIndex], args[2] );
+				break;
+			case DISPLAY_COMMAND::TEXT_CACHED:
+				graphics.drawTextCached( args[0], args[1], &m_Text[command.m_DataIndex], args[2] );
+				break;
+			case DISPLAY_COMMAND::SPRITE_MONOCHROME:
+				graphics.drawSprite( args[0], args[1],
+					*static_cast<Sprite<CP_FORMAT::MONOCHROME_1BIT, api>*>(const_cast<void*>(m_Pointers[command.m_DataIndex])) );
+				break;
+			case DISPLAY_COMMAND::SPRITE_RGBA:
+				graphics.drawSprite( args[0], args[1],
+					*static_cast<Sprite<CP_FORMAT::RGBA_32BIT, api>*>(const_cast<void*>(m_Pointers[command.m_DataIndex])) );
+				break;
+			case DISPLAY_COMMAND::SPRITE_RGB:
+				graphics.drawSprite( args[0], args[1],
+					*static_cast<Sprite<CP_FORMAT::RGB_24BIT, api>*>(const_cast<void*>(m_Pointers[command.m_DataIndex])) );
+				break;
+			case DISPLAY_COMMAND::SPRITE_BGR:
+				graphics.drawSprite( args[0], args[1],
+					*static_cast<Sprite<CP_FORMAT::BGR_24BIT, api>*>(const_cast<void*>(m_Pointers[command.m_DataIndex])) );
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+template <RENDER_API api>
+void DisplayList<api>::optimize()
+{
+	// everything drawn before the last fill is drawn over by it
+	unsigned int lastFillNum = 0;
+	for ( unsigned int commandNum = 0; commandNum < m_Commands.size(); commandNum++ )
+	{
+		if ( m_Commands[commandNum].m_Type == DISPLAY_COMMAND::FILL )
+		{
+			lastFillNum = commandNum;
+		}
+	}
+
+	std::vector<DisplayCommand> commands;
+	std::vector<float> args;
+	std::vector<char> text;
+	std::vector<const void*> pointers;
+	commands.reserve( m_Commands.size() );
+	args.reserve( m_Args.size() );
+
+	auto copyCommand = [&](const DisplayCommand& command)
+	{
+		DisplayCommand copiedCommand = command;
+		copiedCommand.m_ArgsStart = args.size();
+		args.insert( args.end(), m_Args.begin() + command.m_ArgsStart, m_Args.begin() + command.m_ArgsStart + command.m_NumArgs );
+		if ( command.m_Type == DISPLAY_COMMAND::TEXT || command.m_Type == DISPLAY_COMMAND::TEXT_CACHED )
+		{
+			copiedCommand.m_DataIndex = text.size();
+			const char* commandText = &m_Text[command.m_DataIndex];
+			text.insert( text.end(), commandText, commandText + std::strlen(commandText) + 1 );
+		}
+		else if ( command.m_Type == DISPLAY_COMMAND::SET_FONT || command.m_Type >= DISPLAY_COMMAND::SPRITE_MONOCHROME )
+		{
+			copiedCommand.m_DataIndex = pointers.size();
+			pointers.push_back( m_Pointers[command.m_DataIndex] );
+		}
+		commands.push_back( copiedCommand );
+	};
+
+	// colors and fonts are only set once something is drawn with them, and only if they changed since the last thing drawn
+	const DisplayCommand* pendingColor = nullptr;
+	const DisplayCommand* pendingFont = nullptr;
+	const DisplayCommand* drawnColor = nullptr;
+	const DisplayCommand* drawnFont = nullptr;
+	auto flushState = [&]()
+	{
+		if ( pendingColor && ! (drawnColor && this->isSameState(*pendingColor, *drawnColor)) )
+		{
+			copyCommand( *pendingColor );
+			drawnColor = pendingColor;
+		}
+		if ( pendingFont && ! (drawnFont && this->isSameState(*pendingFont, *drawnFont)) )
+		{
+			copyCommand( *pendingFont );
+			drawnFont = pendingFont;
+		}
+	};
+
+	for ( unsigned int commandNum = 0; commandNum < m_Commands.size(); commandNum++ )
+	{
+		const DisplayCommand& command = m_Commands[commandNum];
+		if ( command.m_Type == DISPLAY_COMMAND::SET_FONT )
+		{
+			pendingFont = &command;
+			continue;
+		}
+		if ( this->isStateCommand(command.m_Type) )
+		{
+			pendingColor = &command;
+			continue;
+		}
+		if ( commandNum < lastFillNum )
+		{
+			continue;
+		}
+
+		flushState();
+
+		// the box before has the same color if nothing was set in between
+		if ( command.m_Type == DISPLAY_COMMAND::BOX_FILLED && ! commands.empty() && commands.back().m_Type == DISPLAY_COMMAND::BOX_FILLED
+				&& this->mergeBoxes(&args[commands.back().m_ArgsStart], &m_Args[command.m_ArgsStart]) )
+		{
+			continue;
+		}
+
+		copyCommand( command );
+	}
+
+	// the graphics object is left with the same color and font as without optimizing
+	flushState();
+
+	m_Commands = std::move( commands );
+	m_Args = std::move( args );
+	m_Text = std::move( text );
+	m_Pointers = std::move( pointers );
+}
+
+template <RENDER_API api>
+void DisplayList<api>::clear()
+{
+	m_Commands.clear();
+	m_Args.clear();
+	m_Text.clear();
+	m_Pointers.clear();
+}
+
+template <RENDER_API api>
+inline bool DisplayList<api>::isStateCommand (DISPLAY_COMMAND type)
+{
+	return type == DISPLAY_COMMAND::SET_COLOR_RGB || type == DISPLAY_COMMAND::SET_COLOR_RGBA
+		|| type == DISPLAY_COMMAND::SET_COLOR_MONOCHROME || type == DISPLAY_COMMAND::SET_FONT;
+}
+
+template <RENDER_API api>
+inline bool DisplayList<api>::isSameState (const DisplayCommand& command1, const DisplayCommand& command2) const
+{
+	if ( command1.m_Type != command2.m_Type )
+	{
+		return false;
+	}
+
+	if ( command1.m_Type == DISPLAY_COMMAND::SET_FONT )
+	{
+		return m_Pointers[command1.m_DataIndex] == m_Pointers[command2.m_DataIndex];
+	}
+
+	return std::equal( m_Args.begin() + command1.m_ArgsStart, m_Args.begin() + command1.m_ArgsStart + command1.m_NumArgs,
+				m_Args.begin() + command2.m_ArgsStart );
+}
+
+template <RENDER_API api>
+inline bool DisplayList<api>::mergeBoxes (float* previousBox, const float* box)
+{
+	// only boxes with their start before their end, since drawBoxFilled leaves out the last row and column of the end
+	if ( previousBox[0] > previousBox[2] || previousBox[1] > previousBox[3] || box[0] > box[2] || box[1] > box[3] )
+	{
+		return false;
+	}
+
+	const bool sameRows = previousBox[1] == box[1] && previousBox[3] == box[3];
+	const bool sameColumns = previousBox[0] == box[0] && previousBox[2] == box[2];
+	if ( sameRows && (previousBox[2] == box[0] || previousBox[0] == box[2]) )
+	{
+		previousBox[0] = std::min( previousBox[0], box[0] );
+		previousBox[2] = std::max( previousBox[2], box[2] );
+		return true;
+	}
+	if ( sameColumns && (previousBox[3] == box[1] || previousBox[1] == box[3]) )
+	{
+		previousBox[1] = std::min( previousBox[1], box[1] );
+		previousBox[3] = std::max( previousBox[3], box[3] );
+		return true;
+	}
+
+	// a box inside of the box before doesn't change anything
+	return box[0] >= previousBox[0] && box[1] >= previousBox[1] && box[2] <= previousBox[2] && box[3] <= previousBox[3];
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height>
+bool DisplayList<api>::getPixelBounds (const Font* font, DamageRect& boundsOut) const
+{
+	bool hasBounds = false;
+	float xMin = 0.0f;
+	float yMin = 0.0f;
+	float xMax = 0.0f;
+	float yMax = 0.0f;
+	for ( const DisplayCommand& command : m_Commands )
+	{
+		if ( command.m_Type == DISPLAY_COMMAND::SET_FONT )
+		{
+			font = static_cast<const Font*>( m_Pointers[command.m_DataIndex] );
+		}
+
+		float commandXMin;
+		float commandYMin;
+		float commandXMax;
+		float commandYMax;
+		if ( ! this->getCommandBounds<width, height>(command, font, commandXMin, commandYMin, commandXMax, commandYMax) )
+		{
+			continue;
+		}
+
+		xMin = ( hasBounds ) ? std::min( xMin, commandXMin ) : commandXMin;
+		yMin = ( hasBounds ) ? std::min( yMin, commandYMin ) : commandYMin;
+		xMax = ( hasBounds ) ? std::max( xMax, commandXMax ) : commandXMax;
+		yMax = ( hasBounds ) ? std::max( yMax, commandYMax ) : commandYMax;
+		hasBounds = true;
+	}
+
+	if ( ! hasBounds )
+	{
+		return false;
+	}
+
+	xMin = std::max( std::floor(xMin - m_CullSlack), 0.0f );
+	yMin = std::max( std::floor(yMin - m_CullSlack), 0.0f );
+	xMax = std::min( std::ceil(xMax + m_CullSlack) + 1.0f, static_cast<float>(width) );
+	yMax = std::min( std::ceil(yMax + m_CullSlack) + 1.0f, static_cast<float>(height) );
+	if ( xMin >= xMax || yMin >= yMax )
+	{
+		return false;
+	}
+
+	boundsOut = DamageRect{ static_cast<unsigned int>(xMin), static_cast<unsigned int>(yMin), static_cast<unsigned int>(xMax),
+				static_cast<unsigned int>(yMax) };
+
+	return true;
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height>
+inline bool DisplayList<api>::isOffScreen (const DisplayCommand& command, const Font* font) const
+{
+	float xMin;
+	float yMin;
+	float xMax;
+	float yMax;
+	if ( ! this->getCommandBounds<width, height>(command, font, xMin, yMin, xMax, yMax) )
+	{
+		return true;
+	}
+
+	return xMax < -m_CullSlack || yMax < -m_CullSlack || xMin > (width - 1) + m_CullSlack || yMin > (height - 1) + m_CullSlack;
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height>
+inline bool DisplayList<api>::getCommandBounds (const DisplayCommand& command, const Font* font, float& xMin, float& yMin, float& xMax,
+							float& yMax) const
+{
+	const float* args = &m_Args[command.m_ArgsStart];
+	const float xScale = width - 1;
+	const float yScale = height - 1;
+
+	switch ( command.m_Type )
+	{
+		case DISPLAY_COMMAND::LINE:
+		case DISPLAY_COMMAND::POLYLINE:
+		case DISPLAY_COMMAND::BOX:
+		case DISPLAY_COMMAND::BOX_FILLED:
+		case DISPLAY_COMMAND::TRIANGLE:
+		case DISPLAY_COMMAND::TRIANGLE_FILLED:
+		case DISPLAY_COMMAND::QUAD:
+		case DISPLAY_COMMAND::QUAD_FILLED:
+		{
+			if ( command.m_NumArgs == 0 )
+			{
+				return false;
+			}
+
+			xMin = xMax = args[0];
+			yMin = yMax = args[1];
+			for ( unsigned int argNum = 2; argNum + 1 < command.m_NumArgs; argNum += 2 )
+			{
+				xMin = std::min( xMin, args[argNum] );
+				xMax = std::max( xMax, args[argNum] );
+				yMin = std::min( yMin, args[argNum + 1] );
+				yMax = std::max( yMax, args[argNum + 1] );
+			}
+			xMin *= xScale;
+			xMax *= xScale;
+			yMin *= yScale;
+			yMax *= yScale;
+		}
+			return true;
+		case DISPLAY_COMMAND::CIRCLE:
+		case DISPLAY_COMMAND::CIRCLE_FILLED:
+		case DISPLAY_COMMAND::ELLIPSE_FILLED:
+		{
+			// circles have the same radius in pixels on both axes
+			const float radiusX = std::abs( args[2] ) * xScale;
+			const float radiusY = ( command.m_Type == DISPLAY_COMMAND::ELLIPSE_FILLED ) ? std::abs( args[3] ) * yScale : radiusX;
+			xMin = ( args[0] * xScale ) - radiusX;
+			xMax = ( args[0] * xScale ) + radiusX;
+			yMin = ( args[1] * yScale ) - radiusY;
+			yMax = ( args[1] * yScale ) + radiusY;
+		}
+			return true;
+		case DISPLAY_COMMAND::TEXT:
+		case DISPLAY_COMMAND::TEXT_CACHED:
+		{
+			if ( ! font )
+			{
+				break;
+			}
+
+			// text is drawn on a single line, and scale factors above 1.0f are rounded
+			const float scaleFactor = std::max( std::round(args[2]), 1.0f );
+			const float numCharacters = std::strlen( &m_Text[command.m_DataIndex] );
+			xMin = args[0] * xScale;
+			yMin = args[1] * yScale;
+			xMax = xMin + ( (numCharacters + 1.0f) * font->getCharacterWidth() * scaleFactor );
+			yMax = yMin + ( (font->getBitmapHeight() + 1.0f) * scaleFactor );
+		}
+			return true;
+		case DISPLAY_COMMAND::SPRITE_MONOCHROME:
+			getSpriteBounds<width, height>( *static_cast<const Sprite<CP_FORMAT::MONOCHROME_1BIT, api>*>(m_Pointers[command.m_DataIndex]),
+						args[0], args[1], xMin, yMin, xMax, yMax );
+			return true;
+		case DISPLAY_COMMAND::SPRITE_RGBA:
+			getSpriteBounds<width, height>( *static_cast<const Sprite<CP_FORMAT::RGBA_32BIT, api>*>(m_Pointers[command.m_DataIndex]),
+						args[0], args[1], xMin, yMin, xMax, yMax );
+			return true;
+		case DISPLAY_COMMAND::SPRITE_RGB:
+			getSpriteBounds<width, height>( *static_cast<const Sprite<CP_FORMAT::RGB_24BIT, api>*>(m_Pointers[command.m_DataIndex]),
+						args[0], args[1], xMin, yMin, xMax, yMax );
+			return true;
+		case DISPLAY_COMMAND::SPRITE_BGR:
+			getSpriteBounds<width, height>( *static_cast<const Sprite<CP_FORMAT::BGR_24BIT, api>*>(m_Pointers[command.m_DataIndex]),
+						args[0], args[1], xMin, yMin, xMax, yMax );
+			return true;
+		case DISPLAY_COMMAND::FILL:
+			break;
+		default:
+			// setting state doesn't draw anything
+			return false;
+	}
+
+	// the command can draw anywhere
+	xMin = 0.0f;
+	yMin = 0.0f;
+	xMax = xScale;
+	yMax = yScale;
+
+	return true;
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height, CP_FORMAT spriteFormat>
+inline void DisplayList<api>::getSpriteBounds (const Sprite<spriteFormat, api>& sprite, float xStart, float yStart, float& xMin, float& yMin,
+						float& xMax, float& yMax)
+{
+	// sprites are laid out in pixels from 0 to width, which the camera maps to the pixel columns from 0 to width - 1
+	const float xScale = static_cast<float>( width - 1 ) / static_cast<float>( width );
+	const float yScale = static_cast<float>( height - 1 ) / static_cast<float>( height );
+
+	// sprites are rotated and scaled around their rotation point, so the corners are at the scaled offsets from it
+	const float rotationPointX = ( (xStart * width) + sprite.getRotationPointX() ) * xScale;
+	const float rotationPointY = ( (yStart * height) + sprite.getRotationPointY() ) * yScale;
+	const float scaleFactor = sprite.getScaleFactor();
+	const float leftX = -sprite.getRotationPointX() * scaleFactor * xScale;
+	const float rightX = ( static_cast<float>(sprite.getWidth()) - sprite.getRotationPointX() ) * scaleFactor * xScale;
+	const float topY = -sprite.getRotationPointY() * scaleFactor * yScale;
+	const float bottomY = ( static_cast<float>(sprite.getHeight()) - sprite.getRotationPointY() ) * scaleFactor * yScale;
+
+	if ( sprite.getRotationAngle() == 0 )
+	{
+		xMin = rotationPointX + std::min( leftX, rightX );
+		yMin = rotationPointY + std::min( topY, bottomY );
+		xMax = rotationPointX + std::max( leftX, rightX );
+		yMax = rotationPointY + std::max( topY, bottomY );
+
+		return;
+	}
+
+	// rotated, the corners stay as far from the rotation point as the furthest one is
+	const float cornerX = std::max( std::abs(leftX), std::abs(rightX) );
+	const float cornerY = std::max( std::abs(topY), std::abs(bottomY) );
+	const float reach = std::sqrt( (cornerX * cornerX) + (cornerY * cornerY) );
+
+	xMin = rotationPointX - reach;
+	yMin = rotationPointY - reach;
+	xMax = rotationPointX + reach;
+	yMax = rotationPointY + reach;
+}
+
+#endif // DISPLAYLIST_HPP
@@ -47,6 +47,25 @@ struct Mesh
 	Face transformedFace (unsigned int index);
 };
 
+// a mesh whose faces share vertices, every three indices make up a face
+struct IndexedMesh
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	Matrix<4, 4> transformMat = generateIdentityMatrix();
+
+	// operations on tranformation matrix
+	void scale (float scaleFactor);
+	void translate (float x, float y, float z);
+	void rotate (float x, float y, float z);
+
+	void applyTransformations(); // multiplies vertexes by transformation matrix
+
+	Vertex transformedVertex (unsigned int index) const;
+	Face transformedFace (unsigned int faceIndex) const;
+	unsigned int numFaces() const { return indices.size() / 3; }
+};
+
 struct PointLight
 {
 	Vector<4> position;
@@ -61,10 +80,13 @@ class Camera3D
 		Camera3D (float left, float right, float bottom, float top, float near, float far); // orthographic camera
 
 		void multiplyByCameraMatrix (Face& face);
+		void multiplyByCameraMatrix (Vertex& vertex);
 		void perspectiveDivide (Face& face);
+		void perspectiveDivide (Vertex& vertex);
 
 		// scales the x and y vertices to 0.0f -> 1.0f instead of projected -1.0f to 1.0f
 		void scaleXYToZeroToOne (Face& face) const;
+		void scaleXYToZeroToOne (Vertex& vertex) const;
 
 		float x() const;
 		float y() const;
@@ -4,11 +4,23 @@
 /**************************************************************************
  * The Font class defines a bitmap font that holds a bitmap of all
  * characters. The graphics class can use a Font to blit characters to
- * a frame buffer.
+ * a frame buffer. Characters are looked up in a table of all 256
+ * values of a char, and each glyph is also kept as the runs of set
+ * pixels in its rows, so that text can be drawn as spans instead of
+ * reading the bitmap bit by bit.
 **************************************************************************/
 
 #include <stdint.h>
-#include <map>
+#include <array>
+#include <vector>
+
+// a run of set pixels in one row of a glyph
+struct FontGlyphRun
+{
+	uint8_t row;
+	uint8_t xStart;
+	uint8_t length;
+};
 
 class Font
 {
@@ -20,6 +32,9 @@ class Font
 		unsigned int getBitmapHeight() const;
 
 		unsigned int getCharacterIndex (const char character) const; // returns the offset to begin rendering at
+		bool hasCharacter (const char character) const;
+		// the runs of the glyph of character from top to bottom and left to right, or nullptr if the font doesn't have the character
+		const FontGlyphRun* getGlyphRuns (const char character, unsigned int& numRunsOut) const;
 
 		const uint8_t* getBitmapStart() const;
 
@@ -30,9 +45,12 @@ class Font
 		const unsigned int      m_Height;
 		const unsigned int      m_BitmapStartIndex;
 		const uint8_t*          m_BitmapStart;
-		std::map<char, uint8_t> m_CharMap;
+		std::array<int16_t, 256> m_CharMap; // the glyph of each character, or -1 if the font doesn't have it
+		std::vector<FontGlyphRun> m_GlyphRuns;
+		std::vector<uint32_t> m_GlyphRunStarts; // the first run of each glyph, with one more entry at the end
 
 		void createCharacterMap();
+		void createGlyphRuns();
 };
 
 #endif // FONT_HPP
@@ -0,0 +1,88 @@
+#ifndef FRAMETIMING_HPP
+#define FRAMETIMING_HPP
+
+/**************************************************************************
+ * The TimingHistogram class keeps the last numSamples durations recorded
+ * for something that happens once per frame, and gives percentiles of
+ * them. The FrameTimings struct holds the histograms a Surface keeps.
+ * All durations are in microseconds.
+**************************************************************************/
+
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#ifdef FRAME_TIMING_NUM_SAMPLES
+constexpr unsigned int FRAME_TIMING_SAMPLES = FRAME_TIMING_NUM_SAMPLES;
+#else
+constexpr unsigned int FRAME_TIMING_SAMPLES = 128;
+#endif
+
+using FrameTimingClock = std::chrono::steady_clock;
+
+template <unsigned int numSamples>
+class TimingHistogram
+{
+	public:
+		TimingHistogram() :
+			m_Samples(),
+			m_NextSample( 0 ),
+			m_NumSamples( 0 )
+		{
+			m_Samples.fill( 0 );
+		}
+
+		void addSample (FrameTimingClock::duration duration)
+		{
+			const std::chrono::microseconds::rep microseconds = std::chrono::duration_cast<std::chrono::microseconds>( duration ).count();
+			m_Samples[m_NextSample] = static_cast<uint32_t>( std::max<std::chrono::microseconds::rep>(microseconds, 0) );
+			m_NextSample = ( m_NextSample + 1 ) % numSamples;
+			m_NumSamples = std::min( m_NumSamples + 1, numSamples );
+		}
+
+		// the smallest sample that percentile percent of the samples are less than or equal to, or 0 if there are no samples yet
+		uint32_t getPercentile (float percentile) const
+		{
+			if ( m_NumSamples == 0 )
+			{
+				return 0;
+			}
+
+			std::array<uint32_t, numSamples> sorted = m_Samples;
+			const unsigned int rank = std::ceil( (percentile / 100.0f) * static_cast<float>(m_NumSamples) );
+			const unsigned int index = std::min( std::max(rank, 1u), m_NumSamples ) - 1;
+			std::nth_element( sorted.begin(), sorted.begin() + index, sorted.begin() + m_NumSamples );
+
+			return sorted[index];
+		}
+
+		uint32_t getP50() const { return this->getPercentile( 50.0f ); }
+		uint32_t getP95() const { return this->getPercentile( 95.0f ); }
+		uint32_t getP99() const { return this->getPercentile( 99.0f ); }
+
+		uint32_t getMax() const { return ( m_NumSamples == 0 ) ? 0 : *std::max_element( m_Samples.begin(), m_Samples.begin() + m_NumSamples ); }
+
+		unsigned int getNumSamples() const { return m_NumSamples; }
+
+	private:
+		// until the window is full, the samples are all at the start
+		std::array<uint32_t, numSamples> 	m_Samples;
+		unsigned int 				m_NextSample;
+		unsigned int 				m_NumSamples;
+};
+
+struct FrameTimings
+{
+	// from startFrame to the end of endFrame
+	TimingHistogram<FRAME_TIMING_SAMPLES> drawTime;
+	// spent in advanceFrameBuffer waiting for the next frame to finish rendering, only for threaded surfaces
+	TimingHistogram<FRAME_TIMING_SAMPLES> readWaitTime;
+	// from launching a render thread to it starting to draw, only for threaded surfaces
+	TimingHistogram<FRAME_TIMING_SAMPLES> threadLaunchTime;
+	// from render being called for a frame to advanceFrameBuffer returning it
+	TimingHistogram<FRAME_TIMING_SAMPLES> frameLatency;
+};
+
+#endif // FRAMETIMING_HPP
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <cstdint>
 #include <math.h>
 
 inline bool floatsAreEqual (float x, float y, float diff = std::numeric_limits<float>::epsilon() )
@@ -124,4 +125,152 @@ inline void triSortVertices (float& x1Sorted, float& y1Sorted,
 	}
 }
 
+// walks a triangle edge from its top vertex to its bottom vertex one pixel row at a time. x() is the first pixel column whose center is
+// at or to the right of the edge on the current row, so a span covers the columns [x() of the left edge, x() of the right edge).
+// advance( numRows ) leaves the edge exactly where stepping numRows times would, so rows that are scissored away can be skipped
+class FloatEdge
+{
+	public:
+		FloatEdge (float xTop, float yTop, float xBottom, float yBottom, int startRow) :
+			m_Incr( (yBottom != yTop) ? (xBottom - xTop) / (yBottom - yTop) : 0.0f ),
+			m_Start( xTop + ((static_cast<float>(startRow) - yTop) * m_Incr) ),
+			m_NumSteps( 0 ) {}
+
+		// the first pixel row whose center is at or below y
+		static int ceilRow (float y) { return static_cast<int>( std::ceil(y) ); }
+
+		// x is found from the start row instead of accumulated, so that it doesn't depend on how the edge got to the row
+		int x() const { return static_cast<int>( std::ceil(m_Start + (static_cast<float>(m_NumSteps) * m_Incr)) ); }
+		void step() { m_NumSteps++; }
+		void advance (int numRows) { m_NumSteps += numRows; }
+
+	private:
+		float m_Incr;
+		float m_Start;
+		int m_NumSteps;
+};
+
+// the same as FloatEdge, but with the vertices snapped to 28.4 fixed point and only integer math per row, for targets without an fpu
+class FixedPointEdge
+{
+	public:
+		static constexpr int32_t SUBPIXEL_BITS = 4;
+		static constexpr int32_t SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+
+		FixedPointEdge (float xTop, float yTop, float xBottom, float yBottom, int startRow);
+
+		static int32_t toFixed (float val) { return static_cast<int32_t>( std::floor((val * SUBPIXEL_ONE) + 0.5f) ); }
+		static int ceilRow (float y) { return ceilDiv( toFixed(y), SUBPIXEL_ONE ); }
+
+		int x() const { return m_X; }
+		void step()
+		{
+			m_X += m_XStep;
+			m_Error -= m_ErrorStep;
+			if ( m_Error < 0 )
+			{
+				m_X++;
+				m_Error += m_Denominator;
+			}
+		}
+		void advance (int numRows)
+		{
+			// the error is carried into m_X once for every time it would have gone below zero while stepping
+			const int64_t error = static_cast<int64_t>( m_Error ) - ( static_cast<int64_t>(m_ErrorStep) * numRows );
+			const int64_t numCarries = ( error < 0 ) ? ceilDiv( -error, m_Denominator ) : 0;
+			m_X += static_cast<int32_t>( (static_cast<int64_t>(m_XStep) * numRows) + numCarries );
+			m_Error = static_cast<int32_t>( error + (numCarries * m_Denominator) );
+		}
+
+	private:
+		// the column is ceil( numerator / m_Denominator ), m_Error is the amount m_X * m_Denominator is over the numerator
+		int32_t m_X;
+		int32_t m_Error;
+		int32_t m_XStep;
+		int32_t m_ErrorStep;
+		int32_t m_Denominator;
+
+		static int64_t ceilDiv (int64_t numerator, int64_t denominator)
+		{
+			const int64_t quotient = numerator / denominator;
+			return ( numerator > 0 && quotient * denominator != numerator ) ? quotient + 1 : quotient;
+		}
+		static int64_t floorDiv (int64_t numerator, int64_t denominator)
+		{
+			const int64_t quotient = numerator / denominator;
+			return ( numerator < 0 && quotient * denominator != numerator ) ? quotient - 1 : quotient;
+		}
+};
+
+inline FixedPointEdge::FixedPointEdge (float xTop, float yTop, float xBottom, float yBottom, int startRow)
+{
+	const int32_t x1 = toFixed( xTop );
+	const int32_t y1 = toFixed( yTop );
+	const int32_t dx = toFixed( xBottom ) - x1;
+	const int32_t dy = toFixed( yBottom ) - y1;
+
+	if ( dy <= 0 )
+	{
+		// no rows to walk
+		m_X = ceilDiv( x1, SUBPIXEL_ONE );
+		m_Error = 0;
+		m_XStep = 0;
+		m_ErrorStep = 0;
+		m_Denominator = 1;
+		return;
+	}
+
+	// edge x at a row in subpixels is x1 + ( row * SUBPIXEL_ONE - y1 ) * dx / dy, so in pixels it's numerator / m_Denominator
+	const int64_t numerator = ( static_cast<int64_t>(x1) * dy ) + ( (static_cast<int64_t>(startRow) * SUBPIXEL_ONE - y1) * dx );
+	const int64_t numeratorStep = static_cast<int64_t>( dx ) * SUBPIXEL_ONE;
+	m_Denominator = dy * SUBPIXEL_ONE;
+	m_X = ceilDiv( numerator, m_Denominator );
+	m_Error = ( static_cast<int64_t>(m_X) * m_Denominator ) - numerator;
+	m_XStep = floorDiv( numeratorStep, m_Denominator );
+	m_ErrorStep = numeratorStep - ( static_cast<int64_t>(m_XStep) * m_Denominator );
+}
+
+// FIXED_POINT_RASTERIZATION selects integer edge walking for the triangle rasterizers
+#ifdef FIXED_POINT_RASTERIZATION
+using RasterEdge = FixedPointEdge;
+#else
+using RasterEdge = FloatEdge;
+#endif
+
+// walks the edges of a triangle with vertices sorted by y (see triSortVertices), calling
+// halfFunc( startRow, endRowExclusive, leftEdge, rightEdge ) for the top and then the bottom half. halfFunc is expected to step
+// both edges once for each row it walks. Edge can be given to compare the coverage of FloatEdge and FixedPointEdge in one build
+template <typename Edge = RasterEdge, typename HalfFunc>
+inline void walkTriangleEdges (float x1, float y1, float x2, float y2, float x3, float y3, HalfFunc&& halfFunc)
+{
+	const int y1Ceil = Edge::ceilRow( y1 );
+	const int y2Ceil = Edge::ceilRow( y2 );
+	const int y3Ceil = Edge::ceilRow( y3 );
+
+	// get handedness by calculating area by getting cross product of vectors of lines 1 and 2
+	const float area = ( (x3 - x1) * (y2 - y1) ) - ( (x2 - x1) * (y3 - y1) );
+	const bool leftHanded = ( area >= 0.0f );
+
+	Edge longEdge( x1, y1, x3, y3, y1Ceil );
+	Edge topEdge( x1, y1, x2, y2, y1Ceil );
+	if ( leftHanded )
+	{
+		halfFunc( y1Ceil, y2Ceil, topEdge, longEdge );
+	}
+	else
+	{
+		halfFunc( y1Ceil, y2Ceil, longEdge, topEdge );
+	}
+
+	Edge bottomEdge( x2, y2, x3, y3, y2Ceil );
+	if ( leftHanded )
+	{
+		halfFunc( y2Ceil, y3Ceil, bottomEdge, longEdge );
+	}
+	else
+	{
+		halfFunc( y2Ceil, y3Ceil, longEdge, bottomEdge );
+	}
+}
+
 #endif // GRAPHICSHELPERS_HPP
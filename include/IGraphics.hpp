@@ -25,14 +25,20 @@
 class Font;
 class Camera3D;
 struct Face;
+struct IndexedMesh;
 struct PointLight;
 
+// the number of pixels handed to a batch fragment shader at once
+constexpr unsigned int FRAGMENT_BATCH_SIZE = 8;
+
 #ifdef SOFTWARE_RENDERING
 #define VSHADER void (*vShader)(TriShaderData<format, api, shaderPassDataSize>& vShaderData)
 #define FSHADER void (*fShader)(Color& colorOut, TriShaderData<format, api, shaderPassDataSize>& fShaderData, float v1Cur, float v2Cur, float v3Cur, float texCoordX, float texCoordY, float lightAmnt)
+#define FSHADERBATCH void (*fShaderBatch)(Color* colorsOut, TriShaderData<format, api, shaderPassDataSize>& fShaderData, const float* texCoordsX, const float* texCoordsY, const float* lightAmnts, unsigned int mask)
 #else
 #define VSHADER void (*vShader)(TriShaderData<format, api, shaderPassDataSize>& vShaderData)
 #define FSHADER void (*fShader)(Color& colorOut, TriShaderData<format, api, shaderPassDataSize>& fShaderData, float v1Cur, float v2Cur, float v3Cur, float texCoordX, float texCoordY, float lightAmnt)
+#define FSHADERBATCH void (*fShaderBatch)(Color* colorsOut, TriShaderData<format, api, shaderPassDataSize>& fShaderData, const float* texCoordsX, const float* texCoordsY, const float* lightAmnts, unsigned int mask)
 // TODO use classes for hardware accelerated shaders (and maybe software rendered shaders too?)
 // class VShader;
 // class FShader;
@@ -49,6 +55,9 @@ struct TriShaderData
 	std::vector<PointLight>* lights;
 	VSHADER;
 	FSHADER;
+	// optional, if set the software renderer shades FRAGMENT_BATCH_SIZE pixels per call instead of calling fShader per pixel.
+	// colorsOut, texCoordsX, texCoordsY and lightAmnts have FRAGMENT_BATCH_SIZE entries, only the lanes set in mask need shading
+	FSHADERBATCH = nullptr;
 };
 
 // just to avoid compilation error
@@ -68,6 +77,10 @@ class IGraphics3D
 		virtual void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData) = 0;
 		virtual void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData) = 0;
 		virtual void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData) = 0;
+		virtual void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData) = 0;
+		virtual void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData) = 0;
+		virtual void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData) = 0;
+		virtual void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData) = 0;
 		virtual void drawDepthBuffer (Camera3D& camera) = 0;
 		virtual void clearDepthBuffer() = 0;
 };
@@ -80,13 +93,21 @@ class IGraphics : public std::conditional<include3D, IGraphics3D<api, width, hei
 		inline unsigned int convertYPercentageToUInt (float y) { return y * (height - 1); }
 
 		virtual void setColor (float r, float g, float b) = 0;
+		// only drawCircleFilled, drawEllipseFilled and sprites blend with the alpha, the other primitives draw the color as is
+		virtual void setColor (float r, float g, float b, float a) = 0;
 		virtual void setColor (bool val) = 0;
 
 		virtual void setFont (Font* font) = 0;
 		virtual Font* getFont() = 0;
 
+		// nothing is drawn outside of the clip rect, which is in pixels with exclusive max values and is clamped to the screen. It's
+		// the whole screen until it's set, and like the color it stays set across frames
+		virtual void setClipRect (unsigned int xMin, unsigned int yMin, unsigned int xMaxExclusive, unsigned int yMaxExclusive) = 0;
+
 		virtual void fill() = 0;
 		virtual void drawLine (float xStart, float yStart, float xEnd, float yEnd) = 0;
+		// points holds numPoints x and y pairs, which are connected in order, and the last is connected to the first if closed is true
+		virtual void drawPolyline (const float* points, unsigned int numPoints, bool closed = false) = 0;
 		virtual void drawBox (float xStart, float yStart, float xEnd, float yEnd) = 0;
 		virtual void drawBoxFilled (float xStart, float yStart, float xEnd, float yEnd) = 0;
 		virtual void drawTriangle (float x1, float y1, float x2, float y2, float x3, float y3) = 0;
@@ -95,7 +116,12 @@ class IGraphics : public std::conditional<include3D, IGraphics3D<api, width, hei
 		virtual void drawQuadFilled (float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) = 0;
 		virtual void drawCircle (float originX, float originY, float radius) = 0;
 		virtual void drawCircleFilled (float originX, float originY, float radius) = 0;
+		// radiusX is a percentage of the width and radiusY is a percentage of the height
+		virtual void drawEllipseFilled (float originX, float originY, float radiusX, float radiusY) = 0;
 		virtual void drawText (float xStart, float yStart, const char* text, float scaleFactor) = 0;
+		// draws the same pixels as drawText, but keeps the rendered text so that drawing it again only fills its spans, or for
+		// monochrome, writes its masks. This is for text that doesn't change between frames, like labels
+		virtual void drawTextCached (float xStart, float yStart, const char* text, float scaleFactor) = 0;
 
 		virtual void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::MONOCHROME_1BIT, api>& sprite) = 0;
 		virtual void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::RGBA_32BIT, api>& sprite) = 0;
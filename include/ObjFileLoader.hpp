@@ -32,12 +32,16 @@ class ObjFileLoader
 		~ObjFileLoader();
 
 		bool createMeshFromFile (Mesh& meshOut, const std::string& filePath);
+		// vertices with the same position, tex coord and normal indices are only stored once
+		bool createIndexedMeshFromFile (IndexedMesh& meshOut, const std::string& filePath);
 
 	private:
 		std::vector<Vector<4>> 		m_VertexBuffer;
 		std::vector<Vector<2>> 		m_TexCoordBuffer;
 		std::vector<Vector<4>> 		m_NormalBuffer;
 		std::vector<FaceIndices> 	m_FaceBuffer;
+
+		bool loadBuffersFromFile (const std::string& filePath);
 };
 
 #endif // OBJFILELOADER_HPP
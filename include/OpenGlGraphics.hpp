@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 
 inline void openGLOffsetVerts (float& x1, float& y1, float& x2, float& y2, float& x3, float& y3, float& x4, float& y4);
@@ -38,11 +39,16 @@ class OpenGlGraphics3D : public IGraphics<width, height, format, api, include3D,
 		void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData) override;
 		void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData) override;
 		void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData) override;
 		void drawDepthBuffer (Camera3D& camera) override;
 		void clearDepthBuffer() override;
 
 	protected:
 		template <CP_FORMAT texFormat> void drawTriangleShadedHelper (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData);
+		template <CP_FORMAT texFormat> void drawMeshHelper (const IndexedMesh& mesh, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData);
 
 		using IGraphics<width, height, format, api, include3D, shaderPassDataSize>::m_ColorProfile;
 		using IGraphics<width, height, format, api, include3D, shaderPassDataSize>::m_FB;
@@ -58,13 +64,17 @@ class OpenGlGraphics 	: public std::conditional<include3D, OpenGlGraphics3D<widt
 
 	public:
 		void setColor (float r, float g, float b) override;
+		void setColor (float r, float g, float b, float a) override;
 		void setColor (bool val) override;
 
 		void setFont (Font* font) override;
 		Font* getFont() override;
 
+		void setClipRect (unsigned int xMin, unsigned int yMin, unsigned int xMaxExclusive, unsigned int yMaxExclusive) override;
+
 		void fill() override;
 		void drawLine (float xStart, float yStart, float xEnd, float yEnd) override;
+		void drawPolyline (const float* points, unsigned int numPoints, bool closed = false) override;
 		void drawBox (float xStart, float yStart, float xEnd, float yEnd) override;
 		void drawBoxFilled (float xStart, float yStart, float xEnd, float yEnd) override;
 		void drawTriangle (float x1, float y1, float x2, float y2, float x3, float y3) override;
@@ -73,7 +83,9 @@ class OpenGlGraphics 	: public std::conditional<include3D, OpenGlGraphics3D<widt
 		void drawQuadFilled (float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) override;
 		void drawCircle (float originX, float originY, float radius) override;
 		void drawCircleFilled (float originX, float originY, float radius) override;
+		void drawEllipseFilled (float originX, float originY, float radiusX, float radiusY) override;
 		void drawText (float xStart, float yStart, const char* text, float scaleFactor) override;
+		void drawTextCached (float xStart, float yStart, const char* text, float scaleFactor) override;
 
 		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::MONOCHROME_1BIT, api>& sprite) override;
 		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::RGBA_32BIT, api>& sprite) override;
@@ -221,6 +233,12 @@ void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::
 	m_ColorProfile.setColor( r, g, b );
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::setColor (float r, float g, float b, float a)
+{
+	m_ColorProfile.setColor( r, g, b, a );
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::setColor (bool val)
 {
@@ -240,6 +258,26 @@ Font* OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>:
 	return m_CurrentFont;
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::setClipRect (unsigned int xMin, unsigned int yMin,
+		unsigned int xMaxExclusive, unsigned int yMaxExclusive)
+{
+	xMin = std::min( xMin, width );
+	yMin = std::min( yMin, height );
+	xMaxExclusive = std::max( std::min(xMaxExclusive, width), xMin );
+	yMaxExclusive = std::max( std::min(yMaxExclusive, height), yMin );
+
+	if ( xMin == 0 && yMin == 0 && xMaxExclusive == width && yMaxExclusive == height )
+	{
+		glDisable( GL_SCISSOR_TEST );
+		return;
+	}
+
+	// the scissor box starts at the bottom left of the frame buffer, while y starts at the top of the screen
+	glScissor( xMin, height - yMaxExclusive, xMaxExclusive - xMin, yMaxExclusive - yMin );
+	glEnable( GL_SCISSOR_TEST );
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::startFrame()
 {
@@ -313,6 +351,64 @@ void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::
 	glDeleteBuffers( 1, &VBO );
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawPolyline (const float* points, unsigned int numPoints,
+		bool closed)
+{
+	if ( numPoints < 2 )
+	{
+		return;
+	}
+
+	const Color color = m_ColorProfile.template getColor<format>();
+
+	std::vector<float> vertices;
+	vertices.reserve( numPoints * 3 );
+	for ( unsigned int pointNum = 0; pointNum < numPoints; pointNum++ )
+	{
+		float x = points[(pointNum * 2)];
+		float y = points[(pointNum * 2) + 1];
+		openGLOffsetVerts( x, y );
+
+		// offset so that 0.0f on the x axis and 1.0f on the y axis are still drawn
+		if ( x == -1.0f )
+		{
+			x += 0.00001f;
+		}
+		if ( y == -1.0f )
+		{
+			y += 0.00001f;
+		}
+
+		vertices.push_back( x );
+		vertices.push_back( y );
+		vertices.push_back( 0.0f );
+	}
+
+	GLuint VAO;
+	glGenVertexArrays( 1, &VAO );
+	glBindVertexArray( VAO );
+
+	GLuint VBO;
+	glGenBuffers( 1, &VBO );
+	glBindBuffer( GL_ARRAY_BUFFER, VBO );
+	glBufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW );
+
+	glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0 );
+	glEnableVertexAttribArray( 0 );
+
+	glUseProgram( m_BasicColorProgram );
+
+	const float lineColor[] = { color.m_R, color.m_G, color.m_B, color.m_A };
+	glUniform4fv( glGetUniformLocation(m_BasicColorProgram, "color"), 1, &lineColor[0] );
+
+	// the whole polyline is a single draw call
+	glDrawArrays( (closed) ? GL_LINE_LOOP : GL_LINE_STRIP, 0, numPoints );
+
+	glDeleteVertexArrays( 1, &VAO );
+	glDeleteBuffers( 1, &VBO );
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawBox (float xStart, float yStart, float xEnd, float yEnd)
 {
@@ -445,6 +541,47 @@ void OpenGlGraphics3D<width, height, format, api, include3D, shaderPassDataSize>
 	// TODO draw shaded triangle using shaderData
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->drawMeshHelper<CP_FORMAT::MONOCHROME_1BIT>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->drawMeshHelper<CP_FORMAT::RGBA_32BIT>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->drawMeshHelper<CP_FORMAT::RGB_24BIT>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->drawMeshHelper<CP_FORMAT::BGR_24BIT>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat>
+void OpenGlGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMeshHelper (const IndexedMesh& mesh,
+			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+{
+	// TODO upload the vertices and indices as buffers instead of drawing face by face
+	for ( unsigned int faceNum = 0; faceNum < mesh.numFaces(); faceNum++ )
+	{
+		Face face = mesh.transformedFace( faceNum );
+		this->drawTriangleShadedHelper<texFormat>( face, shaderData );
+	}
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawQuad (float x1, float y1, float x2, float y2, float x3, float y3,
 		float x4, float y4)
@@ -464,17 +601,17 @@ void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::
 }
 
 template <unsigned int width, unsigned int height>
-inline void drawCircleHelper (const GLuint program, const Color& color, float originX, float originY, float radius, bool filled)
+inline void drawEllipseHelper (const GLuint program, const Color& color, float originX, float originY, float radiusX, float radiusY,
+				bool filled)
 {
 	openGLOffsetVerts( originX, originY );
 
 	// TODO this should probably be set dynamically
 	constexpr unsigned int numSegments = 100;
 
-	// need to squish or expand vertical radius to account for aspect ratio
-	radius *= 2.0f;
-	const float rW = radius;
-	const float rH = radius * static_cast<float>( width ) / static_cast<float>( height );
+	// the screen is 2.0f wide and high in normalized device coordinates
+	const float rW = radiusX * 2.0f;
+	const float rH = radiusY * 2.0f;
 
 	float vertices[numSegments * 3];
 
@@ -516,7 +653,9 @@ void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::
 {
 	const Color color = m_ColorProfile.template getColor<format>();
 
-	drawCircleHelper<width, height>( m_BasicColorProgram, color, originX, originY, radius, false );
+	// need to squish or expand vertical radius to account for aspect ratio
+	drawEllipseHelper<width, height>( m_BasicColorProgram, color, originX, originY, radius,
+						radius * static_cast<float>(width) / static_cast<float>(height), false );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
@@ -524,7 +663,18 @@ void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::
 {
 	const Color color = m_ColorProfile.template getColor<format>();
 
-	drawCircleHelper<width, height>( m_BasicColorProgram, color, originX, originY, radius, true );
+	// need to squish or expand vertical radius to account for aspect ratio
+	drawEllipseHelper<width, height>( m_BasicColorProgram, color, originX, originY, radius,
+						radius * static_cast<float>(width) / static_cast<float>(height), true );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawEllipseFilled (float originX, float originY, float radiusX,
+		float radiusY)
+{
+	const Color color = m_ColorProfile.template getColor<format>();
+
+	drawEllipseHelper<width, height>( m_BasicColorProgram, color, originX, originY, radiusX, radiusY, true );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
@@ -533,6 +683,13 @@ void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::
 	// TODO get color from color profile, draw text
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawTextCached (float xStart, float yStart, const char* text,
+		float scaleFactor)
+{
+	this->drawText( xStart, yStart, text, scaleFactor );
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void OpenGlGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawSprite (float xStart, float yStart,
 		Sprite<CP_FORMAT::MONOCHROME_1BIT, api>& sprite)
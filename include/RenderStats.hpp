@@ -0,0 +1,114 @@
+#ifndef RENDERSTATS_HPP
+#define RENDERSTATS_HPP
+
+/**************************************************************************
+ * The RenderStats struct holds the counters the software renderer keeps
+ * for a frame, to find out where the time in a frame went. Counting is
+ * only compiled in when RENDER_STATS is defined, otherwise every place
+ * that counts is discarded with if constexpr and the stats for a frame
+ * are always zero.
+ *
+ * The software renderer can also keep a per pixel heatmap of how often
+ * each pixel was written or how long was spent shading it, which is
+ * drawn over the frame at the end of the frame. The heatmap is only
+ * compiled in when RENDER_HEATMAP is defined.
+**************************************************************************/
+
+#include <array>
+#include <numeric>
+#include <cstdint>
+
+#ifdef RENDER_STATS
+constexpr bool RENDER_STATS_ENABLED = true;
+#else
+constexpr bool RENDER_STATS_ENABLED = false;
+#endif
+
+#ifdef RENDER_HEATMAP
+constexpr bool RENDER_HEATMAP_ENABLED = true;
+#else
+constexpr bool RENDER_HEATMAP_ENABLED = false;
+#endif
+
+enum class HEATMAP_MODE
+{
+	NONE,
+	OVERDRAW, // the number of times each pixel was written, by any primitive
+	SHADER_COST // the clock ticks spent in the fragment shader for each pixel, only shaded triangles and sprites count
+};
+
+// where the rasterizer adds to the heatmap, counts is nullptr if there's nothing to add
+struct HeatmapTarget
+{
+	uint32_t* 	counts;
+	HEATMAP_MODE 	mode;
+};
+
+enum class RENDER_PRIMITIVE : unsigned int
+{
+	FILL,
+	LINE,
+	BOX_FILLED,
+	TRIANGLE_FILLED,
+	CIRCLE,
+	TEXT,
+	TRIANGLE_SHADED,
+	SPRITE,
+	DEPTH_BUFFER,
+	NUM_PRIMITIVES
+};
+
+struct RenderStats
+{
+	// triangles given to drawTriangleShaded, drawSprite or drawMesh
+	unsigned int trianglesSubmitted = 0;
+	unsigned int trianglesBackFaceCulled = 0;
+	// entirely inside of the view, so rasterized without clipping
+	unsigned int trianglesTriviallyAccepted = 0;
+	unsigned int trianglesClipped = 0;
+	// triangles the clipper split the clipped triangles into
+	unsigned int clippedSubTriangles = 0;
+	// rejected by the hierarchical depth test before rasterizing
+	unsigned int trianglesOccluded = 0;
+	// in batches of a span rejected by the hierarchical depth test, so never depth tested
+	unsigned int pixelsOccluded = 0;
+
+	// only the pixels that were depth tested, and with a depth pre-pass only those of the color pass
+	unsigned int depthTestsPassed = 0;
+	unsigned int depthTestsFailed = 0;
+	unsigned int fragmentShaderInvocations = 0;
+
+	std::array<unsigned int, static_cast<unsigned int>(RENDER_PRIMITIVE::NUM_PRIMITIVES)> pixelsWritten{};
+
+	unsigned int& getPixelsWritten (RENDER_PRIMITIVE primitive) { return pixelsWritten[static_cast<unsigned int>(primitive)]; }
+	unsigned int getPixelsWritten (RENDER_PRIMITIVE primitive) const { return pixelsWritten[static_cast<unsigned int>(primitive)]; }
+	unsigned int getTotalPixelsWritten() const { return std::accumulate( pixelsWritten.begin(), pixelsWritten.end(), 0u ); }
+
+	// the average number of times each pixel of the screen was written to
+	float getOverdraw (unsigned int numScreenPixels) const
+	{
+		return static_cast<float>( getTotalPixelsWritten() ) / static_cast<float>( numScreenPixels );
+	}
+
+	RenderStats& operator+= (const RenderStats& other)
+	{
+		trianglesSubmitted += other.trianglesSubmitted;
+		trianglesBackFaceCulled += other.trianglesBackFaceCulled;
+		trianglesTriviallyAccepted += other.trianglesTriviallyAccepted;
+		trianglesClipped += other.trianglesClipped;
+		clippedSubTriangles += other.clippedSubTriangles;
+		trianglesOccluded += other.trianglesOccluded;
+		pixelsOccluded += other.pixelsOccluded;
+		depthTestsPassed += other.depthTestsPassed;
+		depthTestsFailed += other.depthTestsFailed;
+		fragmentShaderInvocations += other.fragmentShaderInvocations;
+		for ( unsigned int primitive = 0; primitive < pixelsWritten.size(); primitive++ )
+		{
+			pixelsWritten[primitive] += other.pixelsWritten[primitive];
+		}
+
+		return *this;
+	}
+};
+
+#endif // RENDERSTATS_HPP
@@ -0,0 +1,630 @@
+#ifndef SCENEGRAPH_HPP
+#define SCENEGRAPH_HPP
+
+/**************************************************************************
+ * The SceneGraph class holds a retained tree of 2D nodes (boxes, circles,
+ * lines, text and sprites, arranged in groups) and draws it into a
+ * Graphics object. Each node records what it draws into its own display
+ * list and keeps the pixel bounds it was last drawn with. When a node is
+ * changed it's invalidated, and the next time the scene graph is drawn
+ * only the areas that changed are cleared to the background color and
+ * redrawn with the nodes that touch them, with the Graphics object
+ * clipped to each area, instead of redrawing the whole frame.
+ *
+ * A Graphics object still holds the frame that was last drawn to it, so
+ * the scene graph remembers which frame each Graphics object was last
+ * drawn with and redraws everything that changed since then. Graphics
+ * objects it hasn't seen, or hasn't seen for more than
+ * SCENE_GRAPH_DAMAGE_HISTORY frames, are redrawn completely. So the
+ * frame buffer shouldn't be drawn to by anything else, and a scene graph
+ * should only be drawn into frame buffers of one size.
+ *
+ * Nodes are owned by the application and only pointed to by their
+ * groups, so they have to outlive the scene graph or be removed from
+ * it first. Setters invalidate the node they're called on, but a node
+ * has to be invalidated by hand when something it points to changes,
+ * like the pixels of a sprite. When render threads can be drawing the
+ * scene graph, nodes should only be changed with getMutex() locked.
+ * Drawing leaves the color of the Graphics object as it was set by the
+ * last node drawn, and its clip rect as the whole screen.
+**************************************************************************/
+
+#include "IGraphics.hpp"
+#include "DisplayList.hpp"
+#include "DamageList.hpp"
+#include "Font.hpp"
+#include "Sprite.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef SCENE_GRAPH_NUM_DAMAGE_FRAMES
+constexpr unsigned int SCENE_GRAPH_DAMAGE_HISTORY = SCENE_GRAPH_NUM_DAMAGE_FRAMES;
+#else
+constexpr unsigned int SCENE_GRAPH_DAMAGE_HISTORY = 8;
+#endif
+
+template <RENDER_API api> class SceneGroupNode;
+template <RENDER_API api> class SceneGraph;
+
+template <RENDER_API api>
+class SceneNode
+{
+	public:
+		virtual ~SceneNode() {}
+
+		void setVisible (bool visible) { m_Visible = visible; this->invalidate(); }
+		bool isVisible() const { return m_Visible; }
+
+		// marks the node to be recorded and redrawn the next time the scene graph is drawn
+		void invalidate();
+
+		SceneGroupNode<api>* getParent() const { return m_Parent; }
+
+	protected:
+		SceneNode() :
+			m_Visible( true ),
+			m_Dirty( true ),
+			m_ChildDirty( false ),
+			m_Parent( nullptr ),
+			m_DisplayList(),
+			m_Bounds{ 0, 0, 0, 0 },
+			m_HasBounds( false ) {}
+
+		// leaf nodes record what they draw, in the same coordinates as IGraphics
+		virtual void record (DisplayList<api>& displayList) const { (void) displayList; }
+		// only groups have children
+		virtual const std::vector<SceneNode<api>*>* getChildren() const { return nullptr; }
+
+	private:
+		bool 			m_Visible;
+		bool 			m_Dirty;
+		bool 			m_ChildDirty; // a node somewhere under this one is dirty
+		SceneGroupNode<api>* 	m_Parent;
+
+		// what the node drew the last time it was drawn, and where. A group's bounds cover all of its children
+		DisplayList<api> 	m_DisplayList;
+		DamageRect 		m_Bounds;
+		bool 			m_HasBounds;
+
+		// marks this node and the nodes above it as having a dirty node under them
+		void markChildDirty();
+		// after a node is removed from its group, it has to be drawn again wherever it's added next
+		void forgetBounds();
+
+		friend class SceneGroupNode<api>;
+		friend class SceneGraph<api>;
+};
+
+template <RENDER_API api>
+class SceneGroupNode : public SceneNode<api>
+{
+	public:
+		SceneGroupNode() :
+			SceneNode<api>(),
+			m_Children(),
+			m_RemovedDamage() {}
+
+		// children are drawn in the order they're added, so later children are drawn on top. A child is removed from the group it
+		// was in first
+		void addChild (SceneNode<api>& child);
+		void removeChild (SceneNode<api>& child);
+
+	protected:
+		const std::vector<SceneNode<api>*>* getChildren() const override { return &m_Children; }
+
+	private:
+		std::vector<SceneNode<api>*> 	m_Children;
+		DamageList 			m_RemovedDamage; // where removed children were drawn
+
+		friend class SceneGraph<api>;
+};
+
+// leaf nodes that draw with a single color
+template <RENDER_API api>
+class SceneColoredNode : public SceneNode<api>
+{
+	public:
+		void setColor (float r, float g, float b, float a = 1.0f) { m_R = r; m_G = g; m_B = b; m_A = a; this->invalidate(); }
+
+	protected:
+		SceneColoredNode() :
+			SceneNode<api>(),
+			m_R( 1.0f ),
+			m_G( 1.0f ),
+			m_B( 1.0f ),
+			m_A( 1.0f ) {}
+
+		void recordColor (DisplayList<api>& displayList) const
+		{
+			if ( m_A < 1.0f )
+			{
+				displayList.setColor( m_R, m_G, m_B, m_A );
+			}
+			else
+			{
+				displayList.setColor( m_R, m_G, m_B );
+			}
+		}
+
+	private:
+		float 	m_R;
+		float 	m_G;
+		float 	m_B;
+		float 	m_A;
+};
+
+template <RENDER_API api>
+class SceneBoxNode : public SceneColoredNode<api>
+{
+	public:
+		SceneBoxNode (float xStart, float yStart, float xEnd, float yEnd, bool filled = true) :
+			SceneColoredNode<api>(),
+			m_XStart( xStart ),
+			m_YStart( yStart ),
+			m_XEnd( xEnd ),
+			m_YEnd( yEnd ),
+			m_Filled( filled ) {}
+
+		void setRect (float xStart, float yStart, float xEnd, float yEnd)
+		{
+			m_XStart = xStart;
+			m_YStart = yStart;
+			m_XEnd = xEnd;
+			m_YEnd = yEnd;
+			this->invalidate();
+		}
+		void setFilled (bool filled) { m_Filled = filled; this->invalidate(); }
+
+	protected:
+		void record (DisplayList<api>& displayList) const override
+		{
+			this->recordColor( displayList );
+			if ( m_Filled )
+			{
+				displayList.drawBoxFilled( m_XStart, m_YStart, m_XEnd, m_YEnd );
+			}
+			else
+			{
+				displayList.drawBox( m_XStart, m_YStart, m_XEnd, m_YEnd );
+			}
+		}
+
+	private:
+		float 	m_XStart;
+		float 	m_YStart;
+		float 	m_XEnd;
+		float 	m_YEnd;
+		bool 	m_Filled;
+};
+
+template <RENDER_API api>
+class SceneCircleNode : public SceneColoredNode<api>
+{
+	public:
+		SceneCircleNode (float originX, float originY, float radius, bool filled = true) :
+			SceneColoredNode<api>(),
+			m_OriginX( originX ),
+			m_OriginY( originY ),
+			m_Radius( radius ),
+			m_Filled( filled ) {}
+
+		void setOrigin (float originX, float originY) { m_OriginX = originX; m_OriginY = originY; this->invalidate(); }
+		void setRadius (float radius) { m_Radius = radius; this->invalidate(); }
+		void setFilled (bool filled) { m_Filled = filled; this->invalidate(); }
+
+	protected:
+		void record (DisplayList<api>& displayList) const override
+		{
+			this->recordColor( displayList );
+			if ( m_Filled )
+			{
+				displayList.drawCircleFilled( m_OriginX, m_OriginY, m_Radius );
+			}
+			else
+			{
+				displayList.drawCircle( m_OriginX, m_OriginY, m_Radius );
+			}
+		}
+
+	private:
+		float 	m_OriginX;
+		float 	m_OriginY;
+		float 	m_Radius;
+		bool 	m_Filled;
+};
+
+template <RENDER_API api>
+class SceneLineNode : public SceneColoredNode<api>
+{
+	public:
+		SceneLineNode (float xStart, float yStart, float xEnd, float yEnd) :
+			SceneColoredNode<api>(),
+			m_XStart( xStart ),
+			m_YStart( yStart ),
+			m_XEnd( xEnd ),
+			m_YEnd( yEnd ) {}
+
+		void setPoints (float xStart, float yStart, float xEnd, float yEnd)
+		{
+			m_XStart = xStart;
+			m_YStart = yStart;
+			m_XEnd = xEnd;
+			m_YEnd = yEnd;
+			this->invalidate();
+		}
+
+	protected:
+		void record (DisplayList<api>& displayList) const override
+		{
+			this->recordColor( displayList );
+			displayList.drawLine( m_XStart, m_YStart, m_XEnd, m_YEnd );
+		}
+
+	private:
+		float 	m_XStart;
+		float 	m_YStart;
+		float 	m_XEnd;
+		float 	m_YEnd;
+};
+
+// the font has to be set, since the text is measured with it. The text is drawn through the text cache, since nodes are only drawn
+// again when they're damaged, and most text in a scene is labels
+template <RENDER_API api>
+class SceneTextNode : public SceneColoredNode<api>
+{
+	public:
+		SceneTextNode (float xStart, float yStart, const std::string& text, Font* font, float scaleFactor = 1.0f) :
+			SceneColoredNode<api>(),
+			m_XStart( xStart ),
+			m_YStart( yStart ),
+			m_Text( text ),
+			m_Font( font ),
+			m_ScaleFactor( scaleFactor ) {}
+
+		void setPosition (float xStart, float yStart) { m_XStart = xStart; m_YStart = yStart; this->invalidate(); }
+		void setText (const std::string& text)
+		{
+			// text that updates every frame often doesn't change, like a clock
+			if ( text != m_Text )
+			{
+				m_Text = text;
+				this->invalidate();
+			}
+		}
+		void setFont (Font* font) { m_Font = font; this->invalidate(); }
+		void setScaleFactor (float scaleFactor) { m_ScaleFactor = scaleFactor; this->invalidate(); }
+
+	protected:
+		void record (DisplayList<api>& displayList) const override
+		{
+			this->recordColor( displayList );
+			displayList.setFont( m_Font );
+			displayList.drawTextCached( m_XStart, m_YStart, m_Text.c_str(), m_ScaleFactor );
+		}
+
+	private:
+		float 		m_XStart;
+		float 		m_YStart;
+		std::string 	m_Text;
+		Font* 		m_Font;
+		float 		m_ScaleFactor;
+};
+
+template <CP_FORMAT spriteFormat, RENDER_API api>
+class SceneSpriteNode : public SceneNode<api>
+{
+	public:
+		SceneSpriteNode (float xStart, float yStart, Sprite<spriteFormat, api>& sprite) :
+			SceneNode<api>(),
+			m_XStart( xStart ),
+			m_YStart( yStart ),
+			m_Sprite( &sprite ) {}
+
+		void setPosition (float xStart, float yStart) { m_XStart = xStart; m_YStart = yStart; this->invalidate(); }
+		void setSprite (Sprite<spriteFormat, api>& sprite) { m_Sprite = &sprite; this->invalidate(); }
+
+	protected:
+		void record (DisplayList<api>& displayList) const override
+		{
+			displayList.drawSprite( m_XStart, m_YStart, *m_Sprite );
+		}
+
+	private:
+		float 				m_XStart;
+		float 				m_YStart;
+		Sprite<spriteFormat, api>* 	m_Sprite;
+};
+
+template <RENDER_API api>
+class SceneGraph
+{
+	public:
+		SceneGraph() :
+			m_Root(),
+			m_BackgroundR( 0.0f ),
+			m_BackgroundG( 0.0f ),
+			m_BackgroundB( 0.0f ),
+			m_BackgroundChanged( true ),
+			m_FrameNum( 0 ),
+			m_FrameDamage(),
+			m_Buffers(),
+			m_Mutex() {}
+
+		SceneGroupNode<api>& getRoot() { return m_Root; }
+
+		void setBackgroundColor (float r, float g, float b)
+		{
+			m_BackgroundR = r;
+			m_BackgroundG = g;
+			m_BackgroundB = b;
+			m_BackgroundChanged = true;
+		}
+
+		std::mutex& getMutex() { return m_Mutex; }
+
+		// records the nodes that changed since the last call, and redraws the parts of graphics that changed since the scene graph was
+		// last drawn into it
+		template <unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
+		void draw (IGraphics<width, height, format, api, include3D, shaderPassDataSize>& graphics);
+
+	private:
+		// the frame the scene graph was last drawn into a Graphics object with
+		struct SceneGraphBuffer
+		{
+			const void* 	graphics;
+			uint64_t 	frameNum;
+		};
+
+		SceneGroupNode<api> 	m_Root;
+
+		float 	m_BackgroundR;
+		float 	m_BackgroundG;
+		float 	m_BackgroundB;
+		bool 	m_BackgroundChanged;
+
+		// the areas that changed in each of the last SCENE_GRAPH_DAMAGE_HISTORY frames, indexed by frame number
+		uint64_t 							m_FrameNum;
+		std::array<DamageList, SCENE_GRAPH_DAMAGE_HISTORY> 	m_FrameDamage;
+		std::vector<SceneGraphBuffer> 					m_Buffers;
+
+		std::mutex 	m_Mutex;
+
+		// records the dirty nodes under node, adding where they were and are now drawn to damage. Every node under a dirty node is
+		// recorded again, since its visibility or position in the tree may have changed
+		template <unsigned int width, unsigned int height>
+		static void updateNode (SceneNode<api>& node, bool visible, bool forced, DamageList& damage);
+		// replays the nodes under node that touch rect, which graphics is clipped to
+		template <unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
+		static void drawNode (const SceneNode<api>& node, const DamageRect& rect,
+					IGraphics<width, height, format, api, include3D, shaderPassDataSize>& graphics);
+
+		static bool overlaps (const DamageRect& rect1, const DamageRect& rect2);
+};
+
+template <RENDER_API api>
+void SceneNode<api>::invalidate()
+{
+	m_Dirty = true;
+	if ( m_Parent )
+	{
+		m_Parent->markChildDirty();
+	}
+}
+
+template <RENDER_API api>
+void SceneNode<api>::markChildDirty()
+{
+	// every node above a dirty node is marked, so the marking can stop at the first node that already is
+	for ( SceneNode<api>* node = this; node && ! node->m_ChildDirty; node = node->m_Parent )
+	{
+		node->m_ChildDirty = true;
+	}
+}
+
+template <RENDER_API api>
+void SceneNode<api>::forgetBounds()
+{
+	m_HasBounds = false;
+	m_Dirty = true;
+	m_DisplayList.clear();
+
+	if ( const std::vector<SceneNode<api>*>* children = this->getChildren() )
+	{
+		for ( SceneNode<api>* child : *children )
+		{
+			child->forgetBounds();
+		}
+	}
+}
+
+template <RENDER_API api>
+void SceneGroupNode<api>::addChild (SceneNode<api>& child)
+{
+	if ( child.m_Parent )
+	{
+		child.m_Parent->removeChild( child );
+	}
+
+	m_Children.push_back( &child );
+	child.m_Parent = this;
+	child.invalidate();
+}
+
+template <RENDER_API api>
+void SceneGroupNode<api>::removeChild (SceneNode<api>& child)
+{
+	const auto childIt = std::find( m_Children.begin(), m_Children.end(), &child );
+	if ( childIt == m_Children.end() )
+	{
+		return;
+	}
+
+	if ( child.m_HasBounds )
+	{
+		m_RemovedDamage.addRect( child.m_Bounds );
+	}
+	child.forgetBounds();
+	child.m_Parent = nullptr;
+	m_Children.erase( childIt );
+
+	// the group only has to clear where the child was, its other children didn't change
+	this->markChildDirty();
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
+void SceneGraph<api>::draw (IGraphics<width, height, format, api, include3D, shaderPassDataSize>& graphics)
+{
+	std::lock_guard<std::mutex> lock( m_Mutex );
+
+	DamageList damage;
+	if ( m_Root.m_Dirty || m_Root.m_ChildDirty )
+	{
+		this->updateNode<width, height>( m_Root, true, false, damage );
+	}
+	if ( m_BackgroundChanged )
+	{
+		damage.addRect( DamageRect{0, 0, width, height} );
+		m_BackgroundChanged = false;
+	}
+
+	m_FrameNum++;
+	m_FrameDamage[m_FrameNum % SCENE_GRAPH_DAMAGE_HISTORY] = damage;
+
+	// the frame buffer holds the frame it was last drawn with, so everything that changed since then is redrawn
+	auto buffer = std::find_if( m_Buffers.begin(), m_Buffers.end(),
+					[&graphics](const SceneGraphBuffer& b) { return b.graphics == &graphics; } );
+	DamageList region;
+	if ( api == RENDER_API::OPENGL || buffer == m_Buffers.end() || m_FrameNum - buffer->frameNum > SCENE_GRAPH_DAMAGE_HISTORY )
+	{
+		region.addRect( DamageRect{0, 0, width, height} );
+	}
+	else
+	{
+		for ( uint64_t frameNum = buffer->frameNum + 1; frameNum <= m_FrameNum; frameNum++ )
+		{
+			region.addList( m_FrameDamage[frameNum % SCENE_GRAPH_DAMAGE_HISTORY] );
+		}
+	}
+
+	if ( buffer == m_Buffers.end() )
+	{
+		m_Buffers.push_back( SceneGraphBuffer{&graphics, m_FrameNum} );
+	}
+	else
+	{
+		buffer->frameNum = m_FrameNum;
+	}
+
+	if ( region.isEmpty() )
+	{
+		return;
+	}
+
+	// each rect is cleared and redrawn on its own with graphics clipped to it, so the nodes that touch it aren't drawn past it
+	// over pixels that didn't change. Text nodes set their own fonts
+	Font* const font = graphics.getFont();
+	for ( const DamageRect& rect : region )
+	{
+		graphics.setClipRect( rect.xMin, rect.yMin, rect.xMaxExclusive, rect.yMaxExclusive );
+		graphics.setColor( m_BackgroundR, m_BackgroundG, m_BackgroundB );
+		graphics.fill();
+		this->drawNode( m_Root, rect, graphics );
+	}
+	graphics.setClipRect( 0, 0, width, height );
+	graphics.setFont( font );
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height>
+void SceneGraph<api>::updateNode (SceneNode<api>& node, bool visible, bool forced, DamageList& damage)
+{
+	visible = visible && node.m_Visible;
+	forced = forced || node.m_Dirty;
+
+	if ( const std::vector<SceneNode<api>*>* children = node.getChildren() )
+	{
+		SceneGroupNode<api>& group = static_cast<SceneGroupNode<api>&>( node );
+		damage.addList( group.m_RemovedDamage );
+		group.m_RemovedDamage.clear();
+
+		node.m_HasBounds = false;
+		for ( SceneNode<api>* child : *children )
+		{
+			if ( forced || child->m_Dirty || child->m_ChildDirty )
+			{
+				updateNode<width, height>( *child, visible, forced, damage );
+			}
+
+			if ( child->m_HasBounds )
+			{
+				const DamageRect& bounds = child->m_Bounds;
+				node.m_Bounds = ( node.m_HasBounds ) ? DamageRect{ std::min(node.m_Bounds.xMin, bounds.xMin),
+								std::min(node.m_Bounds.yMin, bounds.yMin),
+								std::max(node.m_Bounds.xMaxExclusive, bounds.xMaxExclusive),
+								std::max(node.m_Bounds.yMaxExclusive, bounds.yMaxExclusive) } : bounds;
+				node.m_HasBounds = true;
+			}
+		}
+	}
+	else
+	{
+		if ( node.m_HasBounds )
+		{
+			damage.addRect( node.m_Bounds );
+		}
+
+		node.m_DisplayList.clear();
+		node.m_HasBounds = false;
+		if ( visible )
+		{
+			node.record( node.m_DisplayList );
+			node.m_HasBounds = node.m_DisplayList.template getPixelBounds<width, height>( nullptr, node.m_Bounds );
+		}
+
+		if ( node.m_HasBounds )
+		{
+			damage.addRect( node.m_Bounds );
+		}
+	}
+
+	node.m_Dirty = false;
+	node.m_ChildDirty = false;
+}
+
+template <RENDER_API api>
+template <unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
+void SceneGraph<api>::drawNode (const SceneNode<api>& node, const DamageRect& rect,
+				IGraphics<width, height, format, api, include3D, shaderPassDataSize>& graphics)
+{
+	if ( ! node.m_HasBounds || ! overlaps(node.m_Bounds, rect) )
+	{
+		return;
+	}
+
+	if ( const std::vector<SceneNode<api>*>* children = node.getChildren() )
+	{
+		for ( const SceneNode<api>* child : *children )
+		{
+			drawNode( *child, rect, graphics );
+		}
+	}
+	else
+	{
+		node.m_DisplayList.replay( graphics );
+	}
+}
+
+template <RENDER_API api>
+bool SceneGraph<api>::overlaps (const DamageRect& rect1, const DamageRect& rect2)
+{
+	return rect1.xMin < rect2.xMaxExclusive && rect2.xMin < rect1.xMaxExclusive
+		&& rect1.yMin < rect2.yMaxExclusive && rect2.yMin < rect1.yMaxExclusive;
+}
+
+#endif // SCENEGRAPH_HPP
@@ -16,31 +16,236 @@
 #include "Sprite.hpp"
 #include "Texture.hpp"
 #include "Engine3D.hpp"
+#include "DepthBuffer.hpp"
+#include "RenderStats.hpp"
+#include "DamageList.hpp"
+#include "TextCache.hpp"
 
+#include <cstring>
 #include <functional>
 #include <algorithm>
+#include <initializer_list>
 #include <limits>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// a screen space rectangle in pixels that rasterization is restricted to, the max values are exclusive
+struct ScissorRect
+{
+	int xMin;
+	int yMin;
+	int xMaxExclusive;
+	int yMaxExclusive;
+};
+
+// what a rasterization pass writes, see SoftwareGraphics3D::setDepthPrePass
+enum class DEPTH_PASS
+{
+	DEPTH_AND_COLOR, 	// depth test, then shade and write depth for passing pixels
+	DEPTH_ONLY, 		// depth test and write depth for passing pixels, without shading
+	COLOR_ON_EQUAL_DEPTH 	// shade pixels whose depth equals the stored depth, without writing depth
+};
+
+// a shader program lets the software renderer call shaders directly instead of through the function pointers in TriShaderData, so
+// each shader program gets its own raster loop with the shaders inlined. Derive from ShaderProgram and hide the static functions
+// that are needed, fShader is required. Set batchFShader to true to have fShaderBatch called instead of fShader
+struct ShaderProgram
+{
+	static constexpr bool batchFShader = false;
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void vShader (TriShaderData<texFormat, api, shaderPassDataSize>& /*vShaderData*/) {}
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void fShaderBatch (Color* /*colorsOut*/, TriShaderData<texFormat, api, shaderPassDataSize>& /*fShaderData*/,
+			const float* /*texCoordsX*/, const float* /*texCoordsY*/, const float* /*lightAmnts*/, unsigned int /*mask*/) {}
+};
+
+// the default shader program, calls the vShader, fShader and fShaderBatch function pointers stored in the shader data
+struct FunctionPointerShaderProgram
+{
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline bool useFShaderBatch (const TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+	{
+		return shaderData.fShaderBatch != nullptr;
+	}
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void vShader (TriShaderData<texFormat, api, shaderPassDataSize>& vShaderData)
+	{
+		( *vShaderData.vShader )( vShaderData );
+	}
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void fShader (Color& colorOut, TriShaderData<texFormat, api, shaderPassDataSize>& fShaderData, float v1Cur,
+			float v2Cur, float v3Cur, float texCoordX, float texCoordY, float lightAmnt)
+	{
+		( *fShaderData.fShader )( colorOut, fShaderData, v1Cur, v2Cur, v3Cur, texCoordX, texCoordY, lightAmnt );
+	}
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void fShaderBatch (Color* colorsOut, TriShaderData<texFormat, api, shaderPassDataSize>& fShaderData,
+			const float* texCoordsX, const float* texCoordsY, const float* lightAmnts, unsigned int mask)
+	{
+		( *fShaderData.fShaderBatch )( colorsOut, fShaderData, texCoordsX, texCoordsY, lightAmnts, mask );
+	}
+};
+
+// whether the batch fragment shader should be used, known at compile time for everything but the function pointer program
+template <typename ShaderProg, CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+inline bool useFShaderBatch (const TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+{
+	if constexpr ( std::is_same<ShaderProg, FunctionPointerShaderProgram>::value )
+	{
+		return FunctionPointerShaderProgram::useFShaderBatch( shaderData );
+	}
+	else
+	{
+		return ShaderProg::batchFShader;
+	}
+}
+
+// takes a face in clip space
+inline bool isBackFacing (Face& face, const Camera3D& camera)
+{
+	const Vector<4>& vertexVec = face.vertices[0].vec;
+	const Vector<4>& normal = face.calcFaceNormals();
+
+	return ! ( normal.x() * (vertexVec.x() - camera.x())
+			+ normal.y() * (vertexVec.y() - camera.y())
+			+ normal.z() * (vertexVec.z() - camera.z()) <= 0.0f );
+}
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 class SoftwareGraphicsBase : public IGraphics<width, height, format, api, include3D, shaderPassDataSize>
 {
 	public:
+		SoftwareGraphicsBase();
 		virtual ~SoftwareGraphicsBase() {}
 
+		// the number of triangles since the start of the frame that went outside of the guard band after near and far clipping,
+		// and so needed to be clipped against all six planes
+		unsigned int getFullClipCount() const { return m_FullClipCount; }
+
+		// the stats counted during the last frame to reach endFrame, which are all zero unless RENDER_STATS is defined
+		const RenderStats& getRenderStats() const { return m_LastFrameStats; }
+
+		// at the end of each frame the frame is replaced with a heatmap, scaled so that the hottest pixel of the frame is at the top
+		// of the scale. Pixels nothing was written to are black. This does nothing unless RENDER_HEATMAP is defined
+		void setHeatmapMode (HEATMAP_MODE heatmapMode);
+
+		// how everything drawn after this is combined with what's already in the frame buffer, only monochrome frame buffers
+		// support raster ops other than COPY
+		void setRasterOp (RASTER_OP rasterOp);
+
+		// the areas drawn to, in whole fill tiles, during the frames that reached endFrame since clearDamage was last called. The
+		// surface clears it each time it hands the frame buffer over, see SurfaceBase::getDamage
+		const DamageList& getDamage() const { return m_Damage; }
+		// the number of frames that reached endFrame since clearDamage was last called, since a frame can damage nothing
+		unsigned int getNumDamageFrames() const { return m_NumDamageFrames; }
+		void clearDamage() { m_Damage.clear(); m_NumDamageFrames = 0; }
+
 	protected:
-		template <CP_FORMAT texFormat, bool withTransparency = false>
+		// how far outside of the screen (in multiples of the screen size) vertices can go before x and y need to be clipped
+		static constexpr float m_GuardBandSize = 4.0f;
+
+		unsigned int m_FullClipCount;
+
+		// stats counted on the drawing thread are added to m_FrameStats directly, rasterizing can also happen on the tile threads
+		// so it counts into a local RenderStats and adds it with addRenderStats
+		RenderStats 	m_FrameStats;
+		RenderStats 	m_LastFrameStats;
+		std::mutex 	m_FrameStatsMutex;
+
+		void addRenderStats (const RenderStats& renderStats);
+		// for drawing code that only runs on the drawing thread, the pixels written are numPixels pixels in a row from pixelStart
+		inline void countPixelsWritten (RENDER_PRIMITIVE primitive, unsigned int pixelStart, unsigned int numPixels);
+
+		HEATMAP_MODE 		m_HeatmapMode;
+		std::vector<uint32_t> 	m_HeatmapCounts;
+
+		HeatmapTarget getHeatmapTarget();
+		// the tile threads never write the same pixels, so this can be called from any of them
+		inline void addHeatmapWrites (unsigned int pixelStart, unsigned int numPixels);
+		void drawHeatmap();
+
+		// fill() only records the fill color, the fill is then applied to each tile of m_FillTileSize x m_FillTileSize pixels the
+		// first time something is drawn to it and to the untouched tiles at the end of the frame. So drawing code has to call
+		// resolvePendingFill for the pixels it's about to read or write, or discardPendingFill for pixels it will entirely overwrite.
+		// Both also mark the tiles as damaged, which is how the damage of a frame is tracked
+		static constexpr unsigned int m_FillTileSize = 8;
+		static constexpr unsigned int m_NumFillTilesX = ( width  + m_FillTileSize - 1 ) / m_FillTileSize;
+		static constexpr unsigned int m_NumFillTilesY = ( height + m_FillTileSize - 1 ) / m_FillTileSize;
+
+		bool 							m_FillPending;
+		Color 							m_PendingFillColor;
+		std::array<bool, m_NumFillTilesX * m_NumFillTilesY> 	m_FillTilePending;
+		// the tile threads rasterize separate screen tiles, which never share a fill tile, so they can mark tiles at the same time
+		std::array<bool, m_NumFillTilesX * m_NumFillTilesY> 	m_FillTileDamaged;
+		DamageList 						m_Damage;
+		unsigned int 						m_NumDamageFrames;
+
+		// everything drawn is restricted to the clip rect, so the pending fill is only resolved and discarded inside of it
+		ScissorRect 	m_ClipRect;
+
+		inline bool clipRectContains (int x, int y) const
+		{
+			return x >= m_ClipRect.xMin && x < m_ClipRect.xMaxExclusive && y >= m_ClipRect.yMin && y < m_ClipRect.yMaxExclusive;
+		}
+
+		void setPendingFill (const Color& fillColor);
+		inline void resolvePendingFill (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive, ColorProfile<format>& colorProfile);
+		// resolvePendingFill without marking the tiles as damaged, for applying the fill to the untouched tiles at the end of the frame
+		inline void applyPendingFill (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive, ColorProfile<format>& colorProfile);
+		// resolves all of the rows between the two pixels, for drawing code that works in pixel indices
+		inline void resolvePendingFillRows (int pixelStart, int pixelEnd, ColorProfile<format>& colorProfile);
+		// only drops the pending fill for tiles entirely inside of the pixel rect
+		inline void discardPendingFill (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive);
+		// false if the raster op combines the pixels drawn with the pixels underneath them
+		bool rasterOpReplacesPixels() const;
+
+		inline void addDamage (int xMin, int yMin, int xMaxExclusive, int yMaxExclusive);
+		// adds the damaged tiles to m_Damage and clears them for the next frame
+		void updateDamage();
+
+		template <CP_FORMAT texFormat, bool withTransparency = false, typename ShaderProg = FunctionPointerShaderProgram>
 		inline void drawTriangleShadedHelper (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData,
-				std::array<float, width * height>& depthBuffer );
-		template <CP_FORMAT texFormat, bool withTransparency = false>
+				DepthBuffer<width, height>& depthBuffer );
+		// runs the vertex shader, culls and clips the face, then calls rasterizeFunc with each resulting face in 0.0f -> 1.0f space
+		template <CP_FORMAT texFormat, typename ShaderProg, typename RasterizeFunc>
+		inline void transformAndClipTriangle (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData,
+				RasterizeFunc&& rasterizeFunc);
+		// clips a face in clip space that isn't entirely inside of the view, then calls rasterizeFunc like transformAndClipTriangle
+		template <typename RasterizeFunc>
+		inline void clipTriangle (Face& face, Camera3D& camera, RasterizeFunc&& rasterizeFunc);
+		template <CP_FORMAT texFormat, bool withTransparency = false, typename ShaderProg = FunctionPointerShaderProgram,
+				DEPTH_PASS depthPass = DEPTH_PASS::DEPTH_AND_COLOR>
 		inline void renderScanlines (int startRow, int endRowExclusive, float x1, float y1,
-			float& xLeftAccumulator, float& xRightAccumulator, float v1PerspMul, float v1Depth, float xLeftIncr, float xRightIncr,
+			RasterEdge& leftEdge, RasterEdge& rightEdge, float v1PerspMul, float v1Depth,
 			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, Color& currentColor, float texCoordX1, float texCoordY1,
 			float texCoordXXIncr, float texCoordXYIncr, float texCoordYXIncr, float texCoordYYIncr, float perspXIncr,
 			float perspYIncr, float depthXIncr, float depthYIncr, float v1LightAmnt, float lightAmntXIncr, float lightAmntYIncr,
-			std::array<float, width * height>& depthBuffer, int leftHanded);
-		template <CP_FORMAT texFormat, bool withTransparency = false>
+			DepthBuffer<width, height>& depthBuffer, ColorProfile<format>& colorProfile, const ScissorRect& scissor,
+			RenderStats& renderStats, const HeatmapTarget& heatmap);
+		template <CP_FORMAT texFormat, bool withTransparency = false, typename ShaderProg = FunctionPointerShaderProgram,
+				DEPTH_PASS depthPass = DEPTH_PASS::DEPTH_AND_COLOR>
 		inline void renderInBoundsTriangle (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData,
-							std::array<float, width * height>& depthBuffer);
+							DepthBuffer<width, height>& depthBuffer, ColorProfile<format>& colorProfile,
+							const ScissorRect& scissor);
+
+		static constexpr ScissorRect m_FullScreenScissor = { 0, 0, static_cast<int>(width), static_cast<int>(height) };
 
 		using IGraphics<width, height, format, api, include3D, shaderPassDataSize>::m_ColorProfile;
 		using IGraphics<width, height, format, api, include3D, shaderPassDataSize>::m_FB;
@@ -57,7 +262,8 @@ template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API
 class SoftwareGraphics3D : public SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>
 {
 	public:
-		virtual ~SoftwareGraphics3D() {}
+		SoftwareGraphics3D();
+		virtual ~SoftwareGraphics3D();
 
 		void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData) override;
 		void drawTriangleShaded (Face& face, TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData) override;
@@ -66,8 +272,110 @@ class SoftwareGraphics3D : public SoftwareGraphicsBase<width, height, format, ap
 		void drawDepthBuffer (Camera3D& camera) override;
 		void clearDepthBuffer() override;
 
+		// draws using the shaders of ShaderProg (see ShaderProgram) instead of the function pointers in the shader data
+		template <typename ShaderProg, CP_FORMAT texFormat>
+		void drawTriangleShaded (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData);
+
+		// each vertex of the mesh is transformed by the mesh transformation and camera matrices and projected only once per call,
+		// no matter how many faces share it. The vertex shader is called once per call instead of once per face
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData) override;
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData) override;
+		template <typename ShaderProg, CP_FORMAT texFormat>
+		void drawMesh (const IndexedMesh& mesh, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData);
+
+		// in tiled mode drawTriangleShaded only transforms, clips and bins triangles into screen tiles, the tiles are then rasterized
+		// concurrently by numThreads workers when flushTiles() is called, before anything else is drawn or the depth buffer is cleared,
+		// and when the frame ends. Because of this, the shader data (and the textures and camera it references) must stay valid until
+		// the flush, and shaders must be safe to call from multiple threads. The worker threads are started at the first flush that
+		// needs them and wait for the next flush until the graphics object is destroyed
+		void setTiledRendering (bool tiledRendering, unsigned int numThreads = std::thread::hardware_concurrency());
+		bool getTiledRendering() const { return m_TiledRendering; }
+		void flushTiles();
+
+		// in depth pre-pass mode triangles are deferred like in tiled mode and flushed at the same points, then at the flush all of
+		// them are first rasterized into the depth buffer without shading, then rasterized again only shading the pixels whose depth
+		// equals the stored depth. So the fragment shader runs once per visible pixel, at the cost of rasterizing each triangle twice
+		void setDepthPrePass (bool depthPrePass);
+		bool getDepthPrePass() const { return m_DepthPrePass; }
+
 	protected:
-		std::array<float, width * height> 		m_DepthBuffer;
+		static constexpr unsigned int m_TileSize = 64;
+		static constexpr unsigned int m_NumTilesX = ( width  + m_TileSize - 1 ) / m_TileSize;
+		static constexpr unsigned int m_NumTilesY = ( height + m_TileSize - 1 ) / m_TileSize;
+
+		template <CP_FORMAT texFormat>
+		struct BinnedTriangle
+		{
+			Face 							face; // clipped, in 0.0f -> 1.0f space
+			TriShaderData<texFormat, api, shaderPassDataSize> 	shaderData;
+			// the raster loop of the shader program the triangle was drawn with
+			void (SoftwareGraphics3D::*rasterize)(Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData,
+								ColorProfile<format>& colorProfile, const ScissorRect& scissor, DEPTH_PASS depthPass);
+		};
+
+		struct TileEntry
+		{
+			CP_FORMAT 	texFormat;
+			unsigned int 	triangleIndex;
+		};
+
+		// a mesh vertex after the mesh transformation and camera matrices, and if it's inside of the view also after the
+		// perspective divide and scaling to 0.0f -> 1.0f, so faces entirely inside of the view can skip straight to rasterizing
+		struct TransformedVertex
+		{
+			Vertex 		clipVertex;
+			Vertex 		screenVertex;
+			bool 		insideView;
+			unsigned int 	meshDrawNum; // the value of m_MeshDrawNum when this vertex was transformed
+		};
+
+		DepthBuffer<width, height> 						m_DepthBuffer;
+
+		bool 									m_TiledRendering;
+		unsigned int 								m_NumTileThreads;
+		bool 									m_DepthPrePass;
+		std::vector<BinnedTriangle<CP_FORMAT::MONOCHROME_1BIT>> 		m_BinnedTrianglesMonochrome;
+		std::vector<BinnedTriangle<CP_FORMAT::RGBA_32BIT>> 			m_BinnedTrianglesRGBA;
+		std::vector<BinnedTriangle<CP_FORMAT::RGB_24BIT>> 			m_BinnedTrianglesRGB;
+		std::vector<BinnedTriangle<CP_FORMAT::BGR_24BIT>> 			m_BinnedTrianglesBGR;
+		std::array<std::vector<TileEntry>, m_NumTilesX * m_NumTilesY> 	m_TileBins; // triangles per tile in submission order
+		std::atomic<unsigned int> 						m_NextTile;
+		std::vector<std::thread> 						m_TileWorkers; // the thread calling flushTiles() is a worker too
+		std::mutex 								m_TileWorkersMutex;
+		std::condition_variable 						m_TileWorkersStart;
+		std::condition_variable 						m_TileWorkersDone;
+		unsigned int 								m_TileFlushNum; // incremented to start the workers
+		unsigned int 								m_NumTileWorkersFlushing; // the workers used by the current flush
+		unsigned int 								m_NumTileWorkersBusy;
+		bool 									m_StopTileWorkers;
+		std::vector<TransformedVertex> 						m_PostTransformCache; // indexed by mesh vertex index
+		unsigned int 								m_MeshDrawNum;
+
+		template <CP_FORMAT texFormat>
+		std::vector<BinnedTriangle<texFormat>>& getBinnedTriangles();
+		template <CP_FORMAT texFormat, typename ShaderProg>
+		void binTriangle (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData);
+		template <CP_FORMAT texFormat, typename ShaderProg>
+		void binClippedTriangle (Face& clippedFace, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData);
+		// transforms the vertices of the mesh through the post-transform cache, then culls and clips each face and calls
+		// rasterizeFunc with each resulting face in 0.0f -> 1.0f space
+		template <CP_FORMAT texFormat, typename ShaderProg, typename RasterizeFunc>
+		void assembleMeshTriangles (const IndexedMesh& mesh, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData,
+				RasterizeFunc&& rasterizeFunc);
+		template <CP_FORMAT texFormat, typename ShaderProg>
+		void rasterizeInScissor (Face& face, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData,
+						ColorProfile<format>& colorProfile, const ScissorRect& scissor, DEPTH_PASS depthPass);
+		template <CP_FORMAT texFormat>
+		void rasterizeBinnedTriangle (unsigned int triangleIndex, ColorProfile<format>& colorProfile, const ScissorRect& scissor,
+						DEPTH_PASS depthPass);
+		void rasterizeTileBin (unsigned int tileNum, ColorProfile<format>& colorProfile, const ScissorRect& scissor,
+					DEPTH_PASS depthPass);
+		void rasterizeTiles();
+		void startTileWorkers (unsigned int numWorkers);
+		void runTileWorker (unsigned int workerNum, unsigned int lastFlushNum);
+		void stopTileWorkers();
 
 		using IGraphics<width, height, format, api, include3D, shaderPassDataSize>::approxEqual;
 		using IGraphics<width, height, format, api, include3D, shaderPassDataSize>::clip;
@@ -88,13 +396,17 @@ class SoftwareGraphics 	: public std::conditional<include3D, SoftwareGraphics3D<
 
 	public:
 		void setColor (float r, float g, float b) override;
+		void setColor (float r, float g, float b, float a) override;
 		void setColor (bool val) override;
 
 		void setFont (Font* font) override;
 		Font* getFont() override;
 
+		void setClipRect (unsigned int xMin, unsigned int yMin, unsigned int xMaxExclusive, unsigned int yMaxExclusive) override;
+
 		void fill() override;
 		void drawLine (float xStart, float yStart, float xEnd, float yEnd) override;
+		void drawPolyline (const float* points, unsigned int numPoints, bool closed = false) override;
 		void drawBox (float xStart, float yStart, float xEnd, float yEnd) override;
 		void drawBoxFilled (float xStart, float yStart, float xEnd, float yEnd) override;
 		void drawTriangle (float x1, float y1, float x2, float y2, float x3, float y3) override;
@@ -103,22 +415,52 @@ class SoftwareGraphics 	: public std::conditional<include3D, SoftwareGraphics3D<
 		void drawQuadFilled (float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4) override;
 		void drawCircle (float originX, float originY, float radius) override;
 		void drawCircleFilled (float originX, float originY, float radius) override;
+		void drawEllipseFilled (float originX, float originY, float radiusX, float radiusY) override;
 		void drawText (float xStart, float yStart, const char* text, float scaleFactor) override;
+		// downscaled text isn't cached
+		void drawTextCached (float xStart, float yStart, const char* text, float scaleFactor) override;
 
 		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::MONOCHROME_1BIT, api>& sprite) override;
 		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::RGBA_32BIT, api>& sprite) override;
 		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::RGB_24BIT, api>& sprite) override;
 		void drawSprite (float xStart, float yStart, Sprite<CP_FORMAT::BGR_24BIT, api>& sprite) override;
 
+		// each graphics object has its own cache, so render threads don't share one. It has to be cleared before a font it has
+		// drawn with is destroyed
+		TextCache& getTextCache() { return m_TextCache; }
+
 	protected:
+		TextCache 	m_TextCache;
+
+		// the screen edges a point is outside of, lines with both points outside of the same edge are rejected without clipping
+		static constexpr unsigned int m_LineRegionLeft   = 0b0001;
+		static constexpr unsigned int m_LineRegionRight  = 0b0010;
+		static constexpr unsigned int m_LineRegionBottom = 0b0100;
+		static constexpr unsigned int m_LineRegionTop    = 0b1000;
+
+		static inline unsigned int getLineRegion (float x, float y);
+		// only clips lines that cross an edge of the screen, and leaves out the end pixel if skipEnd is true and the end isn't clipped
+		inline void drawLineClipped (float xStart, float yStart, unsigned int startRegion, float xEnd, float yEnd, unsigned int endRegion,
+						bool skipEnd);
+		// draws an integer line with both points on the screen, with spans for horizontal lines and bresenham's algorithm otherwise
+		inline void drawLineInBounds (int xStart, int yStart, int xEnd, int yEnd, bool skipEnd);
+
 		// assumes this line is clipped by the clipEdge
 		inline void computeIntersection (const float clipEdge, bool horizontal, const float tempX1, const float tempY1,
 						const float tempX2, const float tempY2, float& intersectionX, float& intersectionY);
 
 		void drawTriangleFilledHelper (float x1, float y1, float x2, float y2, float x3, float y3);
-		void drawCircleHelper (int originX, int originY, int x, int y, bool filled = false);
+		void drawCircleHelper (int originX, int originY, int x, int y);
+		// fills the ellipse with one clipped span per row, so that no pixel is written twice
+		void drawEllipseFilledHelper (int originX, int originY, int radiusX, int radiusY);
+		// scales text down by skipping rows and columns of the font bitmap
+		void drawTextDownscaled (float xStart, float yStart, const char* text, float scaleFactor);
+		// writes the masks of cached monochrome text with its top left pixel at textX and textY, which are partly in the clip rect
+		void drawTextMasks (int textX, int textY, const RenderedText& renderedText);
 		template <CP_FORMAT texFormat>
 		void drawSpriteHelper (float xStart, float yStart, Sprite<texFormat, api>& sprite);
+		// triangles binned in tiled or depth pre-pass mode were drawn before any 2D primitive, so they're rasterized before it
+		inline void flushDeferredTriangles();
 
 		SoftwareGraphics();
 		virtual ~SoftwareGraphics() override;
@@ -137,7 +479,8 @@ class SoftwareGraphics 	: public std::conditional<include3D, SoftwareGraphics3D<
 };
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::SoftwareGraphics()
+SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::SoftwareGraphics() :
+	m_TextCache( TEXT_CACHE_MAX_BYTES, format == CP_FORMAT::MONOCHROME_1BIT )
 {
 }
 
@@ -152,6 +495,12 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 	m_ColorProfile.setColor( r, g, b );
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::setColor (float r, float g, float b, float a)
+{
+	m_ColorProfile.setColor( r, g, b, a );
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::setColor (bool val)
 {
@@ -170,135 +519,270 @@ Font* SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize
 	return m_CurrentFont;
 }
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::setClipRect (unsigned int xMin, unsigned int yMin,
+		unsigned int xMaxExclusive, unsigned int yMaxExclusive)
+{
+	// triangles drawn before the clip rect changes are clipped by the old one
+	this->flushDeferredTriangles();
+
+	this->m_ClipRect.xMin = std::min( xMin, width );
+	this->m_ClipRect.yMin = std::min( yMin, height );
+	this->m_ClipRect.xMaxExclusive = std::max( std::min(xMaxExclusive, width), xMin );
+	this->m_ClipRect.yMaxExclusive = std::max( std::min(yMaxExclusive, height), yMin );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+inline void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::flushDeferredTriangles()
+{
+	if constexpr ( include3D )
+	{
+		this->flushTiles();
+	}
+}
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::startFrame()
 {
+	this->m_FullClipCount = 0;
+	this->m_FrameStats = RenderStats();
+	std::fill( this->m_HeatmapCounts.begin(), this->m_HeatmapCounts.end(), 0 );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::endFrame()
 {
+	if constexpr ( include3D )
+	{
+		this->flushTiles();
+	}
+
+	// apply the fill to the tiles nothing was drawn to, which were damaged when the fill was set
+	this->applyPendingFill( 0, 0, width, height, m_ColorProfile );
+	this->m_FillPending = false;
+
+	this->drawHeatmap();
+	this->updateDamage();
+
+	this->m_LastFrameStats = this->m_FrameStats;
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::fill()
 {
-	m_ColorProfile.template putPixels<width, height, width * height>( m_FB.getPixels(), 0 );
+	// triangles drawn before the fill have to end up under it, not over it
+	this->flushDeferredTriangles();
+
+	const ScissorRect& clipRect = this->m_ClipRect;
+	const bool clipRectIsFullScreen = clipRect.xMin == 0 && clipRect.yMin == 0 && clipRect.xMaxExclusive == static_cast<int>(width)
+						&& clipRect.yMaxExclusive == static_cast<int>(height);
+	if ( ! this->rasterOpReplacesPixels() || ! clipRectIsFullScreen )
+	{
+		// the fill is combined with everything drawn so far, or only covers the clip rect while the pending fill covers the whole
+		// screen, so it can't wait for the end of the frame
+		this->discardPendingFill( clipRect.xMin, clipRect.yMin, clipRect.xMaxExclusive, clipRect.yMaxExclusive );
+		this->resolvePendingFill( clipRect.xMin, clipRect.yMin, clipRect.xMaxExclusive, clipRect.yMaxExclusive, m_ColorProfile );
+		for ( int row = clipRect.yMin; row < clipRect.yMaxExclusive; row++ )
+		{
+			const unsigned int pixelStart = ( row * width ) + clipRect.xMin;
+			m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixelStart, clipRect.xMaxExclusive - clipRect.xMin );
+			this->countPixelsWritten( RENDER_PRIMITIVE::FILL, pixelStart, clipRect.xMaxExclusive - clipRect.xMin );
+		}
+
+		return;
+	}
+
+	this->setPendingFill( m_ColorProfile.template getColor<format>() );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawLine (float xStart, float yStart, float xEnd, float yEnd)
 {
-	// clip line and return if line is off screen
-	if ( !IGraphics<width, height, format, api, include3D, shaderPassDataSize>::clipLine( &xStart, &yStart, &xEnd, &yEnd ) ) return;
+	this->flushDeferredTriangles();
 
-	const unsigned int xStartUInt = std::ceil( xStart * (width  - 1) );
-	const unsigned int yStartUInt = std::ceil( yStart * (height - 1) );
-	const unsigned int xEndUInt   = std::ceil( xEnd   * (width  - 1) );
-	const unsigned int yEndUInt   = std::ceil( yEnd   * (height - 1) );
+	this->drawLineClipped( xStart, yStart, getLineRegion(xStart, yStart), xEnd, yEnd, getLineRegion(xEnd, yEnd), false );
+}
 
-	const float slope = ((float) yEndUInt - yStartUInt) / ((float)xEndUInt - xStartUInt);
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawPolyline (const float* points, unsigned int numPoints,
+		bool closed)
+{
+	this->flushDeferredTriangles();
 
-	unsigned int pixelStart = ( (width * yStartUInt) + xStartUInt );
-	unsigned int pixelEnd   = ( (width * yEndUInt  ) + xEndUInt   );
+	if ( numPoints < 2 )
+	{
+		return;
+	}
 
-	if ( pixelStart > pixelEnd )
+	// each point is only classified once, and shared with the segments on either side of it
+	float xStart = points[0];
+	float yStart = points[1];
+	unsigned int startRegion = getLineRegion( xStart, yStart );
+	const unsigned int firstRegion = startRegion;
+	const unsigned int numSegments = ( closed ) ? numPoints : numPoints - 1;
+	for ( unsigned int segmentNum = 0; segmentNum < numSegments; segmentNum++ )
 	{
-		// swap
-		const unsigned int temp = pixelStart;
-		pixelStart = pixelEnd;
-		pixelEnd   = temp;
+		const unsigned int endPointNum = ( segmentNum + 1 ) % numPoints;
+		const float xEnd = points[(endPointNum * 2)];
+		const float yEnd = points[(endPointNum * 2) + 1];
+		const unsigned int endRegion = ( endPointNum == 0 ) ? firstRegion : getLineRegion( xEnd, yEnd );
+
+		// the end point of every segment but the last of an open polyline is the start point of the next, so it's only drawn once
+		const bool isLastPoint = ( ! closed ) && ( segmentNum + 1 == numSegments );
+		this->drawLineClipped( xStart, yStart, startRegion, xEnd, yEnd, endRegion, ! isLastPoint );
+
+		xStart = xEnd;
+		yStart = yEnd;
+		startRegion = endRegion;
 	}
+}
 
-	unsigned int pixel = pixelStart;
-	float yAccumulator = 0.0f;
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+inline unsigned int SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::getLineRegion (float x, float y)
+{
+	return ( (x < 0.0f) ? m_LineRegionLeft : 0 ) | ( (x > 1.0f) ? m_LineRegionRight : 0 )
+		| ( (y < 0.0f) ? m_LineRegionTop : 0 ) | ( (y > 1.0f) ? m_LineRegionBottom : 0 );
+}
 
-	if ( xStartUInt == xEndUInt ) // vertical line
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+inline void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawLineClipped (float xStart, float yStart,
+		unsigned int startRegion, float xEnd, float yEnd, unsigned int endRegion, bool skipEnd)
+{
+	if ( startRegion & endRegion ) // both points are outside of the same edge of the screen
 	{
-		while ( pixel <= pixelEnd )
-		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-			pixel += width;
-		}
+		return;
 	}
-	else if ( yStartUInt == yEndUInt ) // horizontal line
+
+	if ( startRegion | endRegion ) // only lines that cross an edge of the screen need the float clipping
 	{
-		while ( pixel <= pixelEnd )
-		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-			pixel += 1;
-		}
+		if ( !IGraphics<width, height, format, api, include3D, shaderPassDataSize>::clipLine( &xStart, &yStart, &xEnd, &yEnd ) ) return;
+
+		// a clipped end point isn't shared with the next segment
+		skipEnd = skipEnd && ( endRegion == 0 );
 	}
-	else if ( slope > 0.0f && slope <= 1.0f )
-	{
-		while ( pixel <= pixelEnd )
-		{
-			// stride x axis
-			while ( yAccumulator < 1.0f && pixel <= pixelEnd )
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-				pixel += 1;
 
-				yAccumulator += slope;
-			}
+	// the clipped points can be outside of the screen by a rounding error
+	const int xStartInt = std::clamp( static_cast<int>(std::ceil(xStart * (width  - 1))), 0, static_cast<int>(width  - 1) );
+	const int yStartInt = std::clamp( static_cast<int>(std::ceil(yStart * (height - 1))), 0, static_cast<int>(height - 1) );
+	const int xEndInt   = std::clamp( static_cast<int>(std::ceil(xEnd   * (width  - 1))), 0, static_cast<int>(width  - 1) );
+	const int yEndInt   = std::clamp( static_cast<int>(std::ceil(yEnd   * (height - 1))), 0, static_cast<int>(height - 1) );
 
-			pixel += width;
-			yAccumulator -= 1.0f;
-		}
+	this->drawLineInBounds( xStartInt, yStartInt, xEndInt, yEndInt, skipEnd );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+inline void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawLineInBounds (int xStart, int yStart, int xEnd,
+		int yEnd, bool skipEnd)
+{
+	const int xDistance = std::abs( xEnd - xStart );
+	const int yDistance = std::abs( yEnd - yStart );
+	const int numPixels = std::max( xDistance, yDistance ) + ( (skipEnd) ? 0 : 1 );
+	if ( numPixels == 0 )
+	{
+		return;
 	}
-	else if ( slope < 0.0f && slope >= -1.0f )
+
+	// lines entirely outside of the clip rect are rejected, and only lines crossing its edges check each pixel against it
+	const ScissorRect& clipRect = this->m_ClipRect;
+	const int lineXMin = std::min( xStart, xEnd );
+	const int lineYMin = std::min( yStart, yEnd );
+	const int lineXMax = std::max( xStart, xEnd );
+	const int lineYMax = std::max( yStart, yEnd );
+	if ( lineXMax < clipRect.xMin || lineXMin >= clipRect.xMaxExclusive || lineYMax < clipRect.yMin || lineYMin >= clipRect.yMaxExclusive )
 	{
-		while ( pixel <= pixelEnd )
-		{
-			// stride x axis
-			while ( yAccumulator < 1.0f && pixel <= pixelEnd - static_cast<unsigned int>(1.0f / -slope) )
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-				pixel -= 1;
+		return;
+	}
+	const bool lineInClipRect = this->clipRectContains( lineXMin, lineYMin ) && this->clipRectContains( lineXMax, lineYMax );
 
-				yAccumulator -= slope;
-			}
+	const int xStep = ( xStart < xEnd ) ? 1 : -1;
+
+	if ( xDistance == 0 || yDistance == 0 )
+	{
+		// straight lines cover their whole bounding box
+		this->resolvePendingFill( lineXMin, lineYMin, lineXMax + 1, lineYMax + 1, m_ColorProfile );
+	}
 
-			pixel += width;
-			yAccumulator -= 1.0f;
+	if ( yDistance == 0 ) // horizontal line
+	{
+		const int spanXStart = std::max( (xStep > 0) ? xStart : xStart - numPixels + 1, clipRect.xMin );
+		const int spanXEnd = std::min( (xStep > 0) ? xStart + numPixels : xStart + 1, clipRect.xMaxExclusive );
+		if ( spanXStart < spanXEnd )
+		{
+			const int pixelStart = ( yStart * static_cast<int>(width) ) + spanXStart;
+			m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixelStart, spanXEnd - spanXStart );
+			this->countPixelsWritten( RENDER_PRIMITIVE::LINE, pixelStart, spanXEnd - spanXStart );
 		}
 	}
-	else if ( slope > 1.0f )
+	else if ( xDistance == 0 ) // vertical line
 	{
-		yAccumulator = slope;
-
-		// stride y axis
-		while ( pixel <= pixelEnd )
+		const int rowStart = std::max( (yStart < yEnd) ? yStart : yStart - numPixels + 1, clipRect.yMin );
+		const int rowEnd = std::min( (yStart < yEnd) ? yStart + numPixels : yStart + 1, clipRect.yMaxExclusive );
+		for ( int row = rowStart; row < rowEnd; row++ )
 		{
-			while ( yAccumulator > 1.0f && pixel <= pixelEnd )
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-				pixel += width;
-
-				yAccumulator -= 1.0f;
-			}
-
-			pixel += 1;
-			yAccumulator += slope;
+			const int pixel = ( row * static_cast<int>(width) ) + xStart;
+			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
+			this->countPixelsWritten( RENDER_PRIMITIVE::LINE, pixel, 1 );
 		}
 	}
-	else if ( slope < -1.0f )
+	else
 	{
-		yAccumulator = slope;
-
-		// stride y axis
-		while ( pixel <= pixelEnd )
+		// bresenham's algorithm for every octant, the error is the distance from the ideal line scaled by both distances
+		const int rowStep = ( yStart < yEnd ) ? 1 : -1;
+		auto stepLine = [xDistance, yDistance, xStep, rowStep](int& error, int& x, int& y)
+			{
+				const int doubleError = error * 2;
+				if ( doubleError >= -yDistance )
+				{
+					error -= yDistance;
+					x += xStep;
+				}
+				if ( doubleError <= xDistance )
+				{
+					error += xDistance;
+					y += rowStep;
+				}
+			};
+
+		// the line is drawn one row of fill tiles at a time, and the pending fill is only resolved for the columns it crosses in that
+		// row, so that a diagonal line doesn't damage its whole bounding box
+		const int fillTileSize = static_cast<int>( this->m_FillTileSize );
+		int error = xDistance - yDistance;
+		int x = xStart;
+		int y = yStart;
+		int pixelNum = 0;
+		while ( pixelNum < numPixels )
 		{
-			while ( yAccumulator < -1.0f && pixel <= pixelEnd )
+			const int fillTileRow = y / fillTileSize;
+			int runError = error;
+			int runX = x;
+			int runY = y;
+			int runNumPixels = 0;
+			int runXMin = x;
+			int runXMax = x;
+			int runYMin = y;
+			int runYMax = y;
+			while ( pixelNum + runNumPixels < numPixels && runY / fillTileSize == fillTileRow )
 			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-				pixel += width;
-
-				yAccumulator += 1.0f;
+				runXMin = std::min( runXMin, runX );
+				runXMax = std::max( runXMax, runX );
+				runYMin = std::min( runYMin, runY );
+				runYMax = std::max( runYMax, runY );
+				stepLine( runError, runX, runY );
+				runNumPixels++;
 			}
 
-			pixel -= 1;
-			yAccumulator += slope;
+			this->resolvePendingFill( runXMin, runYMin, runXMax + 1, runYMax + 1, m_ColorProfile );
+
+			for ( const int runEnd = pixelNum + runNumPixels; pixelNum < runEnd; pixelNum++ )
+			{
+				if ( lineInClipRect || this->clipRectContains(x, y) )
+				{
+					const int linePixel = ( y * static_cast<int>(width) ) + x;
+					m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), linePixel );
+					this->countPixelsWritten( RENDER_PRIMITIVE::LINE, linePixel, 1 );
+				}
+				stepLine( error, x, y );
+			}
 		}
 	}
 }
@@ -306,15 +790,15 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawBox (float xStart, float yStart, float xEnd, float yEnd)
 {
-	drawLine( xStart, yStart, xEnd,   yStart );
-	drawLine( xEnd,   yStart, xEnd,   yEnd   );
-	drawLine( xEnd,   yEnd,   xStart, yEnd   );
-	drawLine( xStart, yEnd,   xStart, yStart );
+	const float points[] = { xStart, yStart, xEnd, yStart, xEnd, yEnd, xStart, yEnd };
+	this->drawPolyline( points, 4, true );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawBoxFilled (float xStart, float yStart, float xEnd, float yEnd)
 {
+	this->flushDeferredTriangles();
+
 	int xStartUInt = xStart * (width  - 1);
 	int yStartUInt = yStart * (height - 1);
 	int xEndUInt   = xEnd   * (width  - 1);
@@ -342,13 +826,54 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 	const unsigned int pStart = pixelStart;
 	const unsigned int pEnd = pixelEnd;
 
-	for (unsigned int pixel = pStart; pixel < pEnd; pixel += width)
+	// rows are drawn from pStart until pEnd, each pixelRowStride pixels long
+	const int boxXMin = pStart % width;
+	const int boxYMin = pStart / width;
+	const int boxYMaxExclusive = boxYMin + ( (pEnd - pStart) + width - 1 ) / width;
+	const ScissorRect& clipRect = this->m_ClipRect;
+	if ( boxXMin + static_cast<int>(pixelRowStride) <= static_cast<int>(width) )
 	{
-		const unsigned int pixelRowEnd = pixel + pixelRowStride;
+		this->discardPendingFill( boxXMin, boxYMin, boxXMin + pixelRowStride, boxYMaxExclusive );
+		this->resolvePendingFill( boxXMin, boxYMin, boxXMin + pixelRowStride, boxYMaxExclusive, m_ColorProfile );
+
+		const int spanXStart = std::max( boxXMin, clipRect.xMin );
+		const int spanXEnd = std::min( boxXMin + static_cast<int>(pixelRowStride), clipRect.xMaxExclusive );
+		if ( spanXStart >= spanXEnd )
+		{
+			return;
+		}
+
+		for ( int row = std::max(boxYMin, clipRect.yMin); row < std::min(boxYMaxExclusive, clipRect.yMaxExclusive); row++ )
+		{
+			const unsigned int pixel = ( row * width ) + spanXStart;
+			m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixel, spanXEnd - spanXStart );
+			this->countPixelsWritten( RENDER_PRIMITIVE::BOX_FILLED, pixel, spanXEnd - spanXStart );
+		}
 
-		for (unsigned int rowPixel = pixel; rowPixel < pixelRowEnd; rowPixel += 1)
+		return;
+	}
+
+	this->resolvePendingFillRows( pStart, pEnd + pixelRowStride, m_ColorProfile );
+
+	// the spans wrap around the right edge of the screen, so each is split where it wraps to be clipped
+	for ( unsigned int pixel = pStart; pixel < pEnd; pixel += width )
+	{
+		const unsigned int spanEnd = std::min( pixel + pixelRowStride, width * height );
+		unsigned int partStart = pixel;
+		while ( partStart < spanEnd )
 		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), rowPixel );
+			const int row = partStart / width;
+			const unsigned int partEnd = std::min( (row + 1) * width, spanEnd );
+			const int partXStart = std::max( static_cast<int>(partStart % width), clipRect.xMin );
+			const int partXEnd = std::min( static_cast<int>(partEnd - (row * width)), clipRect.xMaxExclusive );
+			if ( row >= clipRect.yMin && row < clipRect.yMaxExclusive && partXStart < partXEnd )
+			{
+				const unsigned int partPixel = ( row * width ) + partXStart;
+				m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), partPixel, partXEnd - partXStart );
+				this->countPixelsWritten( RENDER_PRIMITIVE::BOX_FILLED, partPixel, partXEnd - partXStart );
+			}
+
+			partStart = partEnd;
 		}
 	}
 }
@@ -356,9 +881,8 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawTriangle (float x1, float y1, float x2, float y2, float x3, float y3)
 {
-	drawLine( x1, y1, x2, y2 );
-	drawLine( x2, y2, x3, y3 );
-	drawLine( x3, y3, x1, y1 );
+	const float points[] = { x1, y1, x2, y2, x3, y3 };
+	this->drawPolyline( points, 3, true );
 }
 
 
@@ -376,94 +900,33 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 
 	triSortVertices( x1, y1, x2, y2, x3, y3 );
 
-	const int y1Ceil = std::ceil( y1 );
-	const int y2Ceil = std::ceil( y2 );
-	const int y3Ceil = std::ceil( y3 );
+	this->resolvePendingFill( std::floor(std::min({x1, x2, x3})), RasterEdge::ceilRow(y1), std::ceil(std::max({x1, x2, x3})) + 1,
+					RasterEdge::ceilRow(y3), m_ColorProfile );
 
-	// floats for incrementing xLeftAccumulator and xRightAccumulator
-	float xLeftIncrTop     = ( x2 - x1 ) / ( y2 - y1 );
-	float xRightIncrTop    = ( x3 - x1 ) / ( y3 - y1 );
-	float xLeftIncrBottom  = ( x3 - x2 ) / ( y3 - y2 );
-	float xRightIncrBottom = ( x3 - x1 ) / ( y3 - y1 );
-
-	// get handedness by calculating area by getting cross product of vectors of lines 1 and 2
-	const float vec1X = x3 - x1;
-	const float vec1Y = y3 - y1;
-	const float vec2X = x2 - x1;
-	const float vec2Y = y2 - y1;
-
-	const float area = ( vec1X * vec2Y ) - ( vec2X * vec1Y );
-	const int leftHanded = ( area >= 0 ) ? 1 : 0;
-
-	// depending on the position of the vertices, we need to swap increments
-	if ( leftHanded == 0 )
-	{
-		float tempIncr = xLeftIncrTop;
-		xLeftIncrTop = xRightIncrTop;
-		xRightIncrTop = tempIncr;
-
-		tempIncr = xLeftIncrBottom;
-		xLeftIncrBottom = xRightIncrBottom;
-		xRightIncrBottom = tempIncr;
-	}
-
-	// floats for x-intercepts (assuming the top of the triangle is pointed for now)
-	float xLeftAccumulator  = x1 + ( (static_cast<float>(y1Ceil) - y1) * xLeftIncrTop );
-	float xRightAccumulator = x1 + ( (static_cast<float>(y1Ceil) - y1) * xRightIncrTop );
-
-	// render up until the second vertice
-	for ( unsigned int row = y1Ceil; row < y2Ceil && row < height; row++ )
-	{
-		unsigned int leftX =  std::ceil( xLeftAccumulator );
-		unsigned int rightX = std::ceil( xRightAccumulator );
-
-		const unsigned int tempXY1 = ( (row * width) + leftX );
-		const unsigned int tempXY2 = ( (row * width) + rightX );
-
-		for ( unsigned int pixel = tempXY1; pixel < tempXY2; pixel += 1 )
+	const ScissorRect& clipRect = this->m_ClipRect;
+	walkTriangleEdges( x1, y1, x2, y2, x3, y3, [this, &clipRect](int startRow, int endRowExclusive, RasterEdge& leftEdge,
+				RasterEdge& rightEdge)
 		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-		}
-
-		// increment accumulators
-		xLeftAccumulator  += xLeftIncrTop;
-		xRightAccumulator += xRightIncrTop;
-	}
+			// rows above the clip rect are skipped in one go
+			const int firstRow = std::min( std::max(startRow, clipRect.yMin), endRowExclusive );
+			leftEdge.advance( firstRow - startRow );
+			rightEdge.advance( firstRow - startRow );
 
-	if ( y1Ceil != y2Ceil ) // need to account for vert 2 being in the middle of both left and right increments
-	{
-		xLeftAccumulator  += ( (static_cast<float>(y2) - y2Ceil) * xLeftIncrTop )  + ( (static_cast<float>(y2Ceil) - y2) * xLeftIncrBottom );
-		xRightAccumulator += ( (static_cast<float>(y2) - y2Ceil) * xRightIncrTop ) + ( (static_cast<float>(y2Ceil) - y2) * xRightIncrBottom );
-	}
-	else if ( ! floatsAreEqual(y1, y2) ) // still need to account for vert 2 being in the middle of both left and right increments
-	{
-		xLeftAccumulator  = x1 + ( (y2 - y1) * xLeftIncrTop )  + ( (static_cast<float>(y2Ceil) - y2) * xLeftIncrBottom );
-		xRightAccumulator = x1 + ( (y2 - y1) * xRightIncrTop ) + ( (static_cast<float>(y2Ceil) - y2) * xRightIncrBottom );
-	}
-	else
-	{
-		xLeftAccumulator = x1 + ( (static_cast<float>(y2Ceil) - y2) * xLeftIncrBottom );
-		xRightAccumulator = x2 + ( (static_cast<float>(y2Ceil) - y2) * xRightIncrBottom );
-	}
-
-	// rasterize up until the last vertice
-	for ( unsigned int row = y2Ceil; row < y3Ceil && row < height; row++ )
-	{
-		unsigned int leftX =  std::ceil( xLeftAccumulator );
-		unsigned int rightX = std::ceil( xRightAccumulator );
-
-		const unsigned int tempXY1 = ( (row * width) + leftX );
-		const unsigned int tempXY2 = ( (row * width) + rightX );
-
-		for ( unsigned int pixel = tempXY1; pixel < tempXY2; pixel += 1 )
-		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
-		}
+			for ( int row = firstRow; row < endRowExclusive && row < clipRect.yMaxExclusive; row++ )
+			{
+				const int spanXStart = std::max( leftEdge.x(), clipRect.xMin );
+				const int spanXEnd = std::min( rightEdge.x(), clipRect.xMaxExclusive );
+				if ( spanXStart < spanXEnd )
+				{
+					const unsigned int pixelStart = ( row * width ) + spanXStart;
+					m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixelStart, spanXEnd - spanXStart );
+					this->countPixelsWritten( RENDER_PRIMITIVE::TRIANGLE_FILLED, pixelStart, spanXEnd - spanXStart );
+				}
 
-		// increment accumulators
-		xLeftAccumulator  += xLeftIncrBottom;
-		xRightAccumulator += xRightIncrBottom;
-	}
+				leftEdge.step();
+				rightEdge.step();
+			}
+		} );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
@@ -493,6 +956,8 @@ template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleFilled (float x1, float y1, float x2, float y2,
 													float x3, float y3)
 {
+	this->flushDeferredTriangles();
+
 	constexpr unsigned int maxPossibleVerts = 6;
 	std::pair<float, float> outVertices[maxPossibleVerts] = { {x1, y1}, {x2, y2}, {x3, y3}, {0.0f, 0.0f}, {0.0f, 0.0f}, {0.0f, 0.0f} };
 	unsigned int outVerticesSize = 3;
@@ -608,72 +1073,1087 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-void SoftwareGraphics3D<width, height, format, api,  include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
-		TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData)
+SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::SoftwareGraphicsBase() :
+	m_FullClipCount( 0 ),
+	m_FrameStats(),
+	m_LastFrameStats(),
+	m_FrameStatsMutex(),
+	m_HeatmapMode( HEATMAP_MODE::NONE ),
+	m_HeatmapCounts(),
+	m_FillPending( false ),
+	m_PendingFillColor(),
+	m_FillTilePending(),
+	m_FillTileDamaged(),
+	m_Damage(),
+	m_NumDamageFrames( 0 ),
+	m_ClipRect( m_FullScreenScissor )
 {
-	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-		drawTriangleShadedHelper<CP_FORMAT::MONOCHROME_1BIT>( face, shaderData, m_DepthBuffer );
+	m_FillTilePending.fill( false );
+	m_FillTileDamaged.fill( false );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
-		TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData)
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::addRenderStats (const RenderStats& renderStats)
 {
-	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-		drawTriangleShadedHelper<CP_FORMAT::RGBA_32BIT>( face, shaderData, m_DepthBuffer );
+	if constexpr ( RENDER_STATS_ENABLED )
+	{
+		std::lock_guard<std::mutex> lock( m_FrameStatsMutex );
+		m_FrameStats += renderStats;
+	}
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
-		TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData)
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::countPixelsWritten (RENDER_PRIMITIVE primitive,
+		unsigned int pixelStart, unsigned int numPixels)
 {
-	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-		drawTriangleShadedHelper<CP_FORMAT::RGB_24BIT>( face, shaderData, m_DepthBuffer );
+	if constexpr ( RENDER_STATS_ENABLED )
+	{
+		m_FrameStats.getPixelsWritten( primitive ) += numPixels;
+	}
+
+	this->addHeatmapWrites( pixelStart, numPixels );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
-		TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData)
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::setHeatmapMode (HEATMAP_MODE heatmapMode)
 {
-	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-		drawTriangleShadedHelper<CP_FORMAT::BGR_24BIT>( face, shaderData, m_DepthBuffer );
+	if constexpr ( RENDER_HEATMAP_ENABLED )
+	{
+		m_HeatmapMode = heatmapMode;
+		m_HeatmapCounts.assign( (heatmapMode == HEATMAP_MODE::NONE) ? 0 : width * height, 0 );
+	}
 }
 
-inline float calcIncr(const Vector<3>& values, float xy1, float xy2, float xy3, float oneOverdXY)
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::setRasterOp (RASTER_OP rasterOp)
 {
-	const float retVal = ( ((values.at(1) - values.at(2)) * (xy1 - xy3)) - ((values.at(0) - values.at(2)) * (xy2 - xy3)) ) * oneOverdXY;
-	return ( retVal > 100000.0f || retVal < -100000.0f ) ? 0.0f : retVal;
+	static_assert( format == CP_FORMAT::MONOCHROME_1BIT, "raster ops are only supported for monochrome frame buffers" );
+
+	m_ColorProfile.setRasterOp( rasterOp );
 }
 
-inline float saturate (float val)
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+bool SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::rasterOpReplacesPixels() const
 {
-	if ( val > 1.0f ) return 1.0f; else if ( val < 0.0f ) return 0.0f; else return val;
+	if constexpr ( format == CP_FORMAT::MONOCHROME_1BIT )
+	{
+		return m_ColorProfile.getRasterOp() == RASTER_OP::COPY;
+	}
+
+	return true;
 }
 
-template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize,
-	CP_FORMAT texFormat, bool withTransparency>
-inline void renderScanlinesHelper (int startRow, int endRowExclusive, float x1, float y1, float& xLeftAccumulator, float& xRightAccumulator,
-					float v1PerspMul, float v1Depth, float xLeftIncr, float xRightIncr,
-					TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, Color& currentColor, float texCoordX1,
-					float texCoordY1, float texCoordXXIncr, float texCoordXYIncr, float texCoordYXIncr, float texCoordYYIncr,
-					float perspXIncr, float perspYIncr, float depthXIncr, float depthYIncr, float v1LightAmnt,
-					float lightAmntXIncr, float lightAmntYIncr, std::array<float, width * height>& depthBuffer,
-					ColorProfile<format>& colorProfile, FrameBufferFixed<width, height, format, api>& fb, int leftHanded)
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+HeatmapTarget SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::getHeatmapTarget()
 {
-	for ( unsigned int row = startRow; row < endRowExclusive && row < height; row++ )
+	if ( m_HeatmapMode == HEATMAP_MODE::NONE )
 	{
-		const unsigned int leftX  = std::ceil( xLeftAccumulator );
-		const unsigned int rightX = std::ceil( xRightAccumulator );
+		return HeatmapTarget{ nullptr, HEATMAP_MODE::NONE };
+	}
 
-		const unsigned int tempXY1 = ( (row * width) + leftX );
-		const unsigned int tempXY2 = ( (row * width) + rightX );
+	return HeatmapTarget{ m_HeatmapCounts.data(), m_HeatmapMode };
+}
 
-		// offsetting float values from origin for Incr values
-		const float rowF = static_cast<float>( row ) - y1;
-		const float leftXF  = static_cast<float>( leftX ) - x1;
-		const float rightXF = static_cast<float>( rightX ) - x1;
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::addHeatmapWrites (unsigned int pixelStart,
+		unsigned int numPixels)
+{
+	if constexpr ( RENDER_HEATMAP_ENABLED )
+	{
+		// only shaded pixels have a shader cost
+		if ( m_HeatmapMode != HEATMAP_MODE::OVERDRAW )
+		{
+			return;
+		}
+
+		const unsigned int pixelEnd = std::min( pixelStart + numPixels, width * height );
+		for ( unsigned int pixel = pixelStart; pixel < pixelEnd; pixel++ )
+		{
+			m_HeatmapCounts[pixel]++;
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::drawHeatmap()
+{
+	if constexpr ( RENDER_HEATMAP_ENABLED )
+	{
+		if ( m_HeatmapMode == HEATMAP_MODE::NONE )
+		{
+			return;
+		}
+
+		// the heatmap replaces every pixel
+		m_FillTileDamaged.fill( true );
+
+		// get previous color, since we'll want to set it back when we're done with the heatmap colors
+		const Color previousColor = m_ColorProfile.template getColor<format>();
+
+		const float oneOverMaxCount = 1.0f / static_cast<float>( std::max(*std::max_element(m_HeatmapCounts.begin(), m_HeatmapCounts.end()), 1u) );
+		for ( unsigned int pixel = 0; pixel < width * height; pixel++ )
+		{
+			const float heat = static_cast<float>( m_HeatmapCounts[pixel] ) * oneOverMaxCount;
+			if constexpr ( format == CP_FORMAT::MONOCHROME_1BIT )
+			{
+				m_ColorProfile.setColor( heat > 0.5f );
+			}
+			else if ( m_HeatmapCounts[pixel] == 0 )
+			{
+				m_ColorProfile.setColor( 0.0f, 0.0f, 0.0f );
+			}
+			else
+			{
+				// blue through green and yellow to red, setColor clamps each channel
+				m_ColorProfile.setColor( 1.5f - std::abs((4.0f * heat) - 3.0f), 1.5f - std::abs((4.0f * heat) - 2.0f),
+								1.5f - std::abs((4.0f * heat) - 1.0f) );
+			}
+
+			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
+		}
+
+		m_ColorProfile.setColor( previousColor );
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::setPendingFill (const Color& fillColor)
+{
+	// a fill replaces everything drawn before it, including any earlier pending fill
+	m_FillPending = true;
+	m_PendingFillColor = fillColor;
+	m_FillTilePending.fill( true );
+	m_FillTileDamaged.fill( true );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::resolvePendingFill (int xMin, int yMin, int xMaxExclusive,
+		int yMaxExclusive, ColorProfile<format>& colorProfile)
+{
+	xMin = std::max( xMin, m_ClipRect.xMin );
+	yMin = std::max( yMin, m_ClipRect.yMin );
+	xMaxExclusive = std::min( xMaxExclusive, m_ClipRect.xMaxExclusive );
+	yMaxExclusive = std::min( yMaxExclusive, m_ClipRect.yMaxExclusive );
+
+	this->addDamage( xMin, yMin, xMaxExclusive, yMaxExclusive );
+	this->applyPendingFill( xMin, yMin, xMaxExclusive, yMaxExclusive, colorProfile );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::applyPendingFill (int xMin, int yMin, int xMaxExclusive,
+		int yMaxExclusive, ColorProfile<format>& colorProfile)
+{
+	if ( ! m_FillPending )
+	{
+		return;
+	}
+
+	xMin = std::max( xMin, 0 );
+	yMin = std::max( yMin, 0 );
+	xMaxExclusive = std::min( xMaxExclusive, static_cast<int>(width) );
+	yMaxExclusive = std::min( yMaxExclusive, static_cast<int>(height) );
+	if ( xMin >= xMaxExclusive || yMin >= yMaxExclusive )
+	{
+		return;
+	}
+
+	const unsigned int tileXEnd = ( xMaxExclusive - 1 ) / m_FillTileSize;
+	const unsigned int tileYEnd = ( yMaxExclusive - 1 ) / m_FillTileSize;
+	for ( unsigned int tileY = yMin / m_FillTileSize; tileY <= tileYEnd; tileY++ )
+	{
+		unsigned int tileX = xMin / m_FillTileSize;
+		while ( tileX <= tileXEnd )
+		{
+			if ( ! m_FillTilePending[(tileY * m_NumFillTilesX) + tileX] )
+			{
+				tileX++;
+				continue;
+			}
+
+			// pending tiles next to each other in a row are filled together, so that the spans are as long as possible
+			unsigned int runTileXEnd = tileX;
+			while ( runTileXEnd <= tileXEnd && m_FillTilePending[(tileY * m_NumFillTilesX) + runTileXEnd] )
+			{
+				m_FillTilePending[(tileY * m_NumFillTilesX) + runTileXEnd] = false;
+				runTileXEnd++;
+			}
+
+			// get previous color, since we'll want to set it back when we're done with the fill color
+			const Color previousColor = colorProfile.template getColor<format>();
+			colorProfile.setColor( m_PendingFillColor );
+			// the fill was recorded when nothing else was drawn yet, so it's always copied
+			RASTER_OP previousRasterOp = RASTER_OP::COPY;
+			if constexpr ( format == CP_FORMAT::MONOCHROME_1BIT )
+			{
+				previousRasterOp = colorProfile.getRasterOp();
+				colorProfile.setRasterOp( RASTER_OP::COPY );
+			}
+
+			const unsigned int pixelXStart = tileX * m_FillTileSize;
+			const unsigned int pixelXEnd = std::min( runTileXEnd * m_FillTileSize, width );
+			const unsigned int pixelYEnd = std::min( (tileY + 1) * m_FillTileSize, height );
+			for ( unsigned int pixelY = tileY * m_FillTileSize; pixelY < pixelYEnd; pixelY++ )
+			{
+				colorProfile.template putSpan<width, height>( m_FB.getPixels(), (pixelY * width) + pixelXStart, pixelXEnd - pixelXStart );
+				this->addHeatmapWrites( (pixelY * width) + pixelXStart, pixelXEnd - pixelXStart );
+			}
+
+			colorProfile.setColor( previousColor );
+			if constexpr ( format == CP_FORMAT::MONOCHROME_1BIT )
+			{
+				colorProfile.setRasterOp( previousRasterOp );
+			}
+
+			if constexpr ( RENDER_STATS_ENABLED )
+			{
+				// the fill can be resolved by the tile threads
+				RenderStats renderStats;
+				renderStats.getPixelsWritten( RENDER_PRIMITIVE::FILL ) += ( pixelXEnd - pixelXStart ) * ( pixelYEnd - (tileY * m_FillTileSize) );
+				this->addRenderStats( renderStats );
+			}
+
+			tileX = runTileXEnd;
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::resolvePendingFillRows (int pixelStart, int pixelEnd,
+		ColorProfile<format>& colorProfile)
+{
+	if ( pixelStart > pixelEnd )
+	{
+		std::swap( pixelStart, pixelEnd );
+	}
+
+	this->resolvePendingFill( 0, pixelStart / static_cast<int>(width), width, (pixelEnd / static_cast<int>(width)) + 1, colorProfile );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::discardPendingFill (int xMin, int yMin, int xMaxExclusive,
+		int yMaxExclusive)
+{
+	// only the part of the rect inside of the clip rect is drawn
+	xMin = std::max( xMin, m_ClipRect.xMin );
+	yMin = std::max( yMin, m_ClipRect.yMin );
+	xMaxExclusive = std::min( xMaxExclusive, m_ClipRect.xMaxExclusive );
+	yMaxExclusive = std::min( yMaxExclusive, m_ClipRect.yMaxExclusive );
+	if ( xMin >= xMaxExclusive || yMin >= yMaxExclusive )
+	{
+		return;
+	}
+
+	this->addDamage( xMin, yMin, xMaxExclusive, yMaxExclusive );
+
+	if ( ! m_FillPending )
+	{
+		return;
+	}
+
+	// pixels drawn with the other raster ops are combined with the fill, so it has to be there first
+	if ( ! this->rasterOpReplacesPixels() )
+	{
+		this->resolvePendingFill( xMin, yMin, xMaxExclusive, yMaxExclusive, m_ColorProfile );
+		return;
+	}
+
+	// a tile at the right or bottom edge of the screen is entirely covered if the rect reaches the edge
+	const unsigned int tileXStart = ( std::max(xMin, 0) + m_FillTileSize - 1 ) / m_FillTileSize;
+	const unsigned int tileYStart = ( std::max(yMin, 0) + m_FillTileSize - 1 ) / m_FillTileSize;
+	const unsigned int tileXEnd = ( xMaxExclusive >= static_cast<int>(width) )  ? m_NumFillTilesX : std::max( xMaxExclusive, 0 ) / m_FillTileSize;
+	const unsigned int tileYEnd = ( yMaxExclusive >= static_cast<int>(height) ) ? m_NumFillTilesY : std::max( yMaxExclusive, 0 ) / m_FillTileSize;
+	for ( unsigned int tileY = tileYStart; tileY < tileYEnd; tileY++ )
+	{
+		for ( unsigned int tileX = tileXStart; tileX < tileXEnd; tileX++ )
+		{
+			m_FillTilePending[(tileY * m_NumFillTilesX) + tileX] = false;
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::addDamage (int xMin, int yMin, int xMaxExclusive,
+		int yMaxExclusive)
+{
+	xMin = std::max( xMin, 0 );
+	yMin = std::max( yMin, 0 );
+	xMaxExclusive = std::min( xMaxExclusive, static_cast<int>(width) );
+	yMaxExclusive = std::min( yMaxExclusive, static_cast<int>(height) );
+	if ( xMin >= xMaxExclusive || yMin >= yMaxExclusive )
+	{
+		return;
+	}
+
+	const unsigned int tileXEnd = ( xMaxExclusive - 1 ) / m_FillTileSize;
+	const unsigned int tileYEnd = ( yMaxExclusive - 1 ) / m_FillTileSize;
+	for ( unsigned int tileY = yMin / m_FillTileSize; tileY <= tileYEnd; tileY++ )
+	{
+		for ( unsigned int tileX = xMin / m_FillTileSize; tileX <= tileXEnd; tileX++ )
+		{
+			m_FillTileDamaged[(tileY * m_NumFillTilesX) + tileX] = true;
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::updateDamage()
+{
+	// each run of damaged tiles in a row is added as a rect, the damage list merges the runs of rows below each other
+	for ( unsigned int tileY = 0; tileY < m_NumFillTilesY; tileY++ )
+	{
+		unsigned int tileX = 0;
+		while ( tileX < m_NumFillTilesX )
+		{
+			if ( ! m_FillTileDamaged[(tileY * m_NumFillTilesX) + tileX] )
+			{
+				tileX++;
+				continue;
+			}
+
+			unsigned int runTileXEnd = tileX;
+			while ( runTileXEnd < m_NumFillTilesX && m_FillTileDamaged[(tileY * m_NumFillTilesX) + runTileXEnd] )
+			{
+				runTileXEnd++;
+			}
+
+			m_Damage.addRect( DamageRect{ tileX * m_FillTileSize, tileY * m_FillTileSize, std::min(runTileXEnd * m_FillTileSize, width),
+								std::min((tileY + 1) * m_FillTileSize, height) } );
+
+			tileX = runTileXEnd;
+		}
+	}
+
+	m_FillTileDamaged.fill( false );
+	m_NumDamageFrames++;
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::SoftwareGraphics3D() :
+	m_TiledRendering( false ),
+	m_NumTileThreads( 1 ),
+	m_DepthPrePass( false ),
+	m_BinnedTrianglesMonochrome(),
+	m_BinnedTrianglesRGBA(),
+	m_BinnedTrianglesRGB(),
+	m_BinnedTrianglesBGR(),
+	m_TileBins(),
+	m_NextTile( 0 ),
+	m_TileWorkers(),
+	m_TileWorkersMutex(),
+	m_TileWorkersStart(),
+	m_TileWorkersDone(),
+	m_TileFlushNum( 0 ),
+	m_NumTileWorkersFlushing( 0 ),
+	m_NumTileWorkersBusy( 0 ),
+	m_StopTileWorkers( false ),
+	m_PostTransformCache(),
+	m_MeshDrawNum( 0 )
+{
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::~SoftwareGraphics3D()
+{
+	this->stopTileWorkers();
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::setTiledRendering (bool tiledRendering, unsigned int numThreads)
+{
+	// don't leave any triangles binned with the old settings
+	this->flushTiles();
+
+	m_TiledRendering = tiledRendering;
+	m_NumTileThreads = std::max( numThreads, 1u );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::setDepthPrePass (bool depthPrePass)
+{
+	// triangles deferred without a pre-pass need to be drawn that way
+	this->flushTiles();
+
+	m_DepthPrePass = depthPrePass;
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat>
+std::vector<typename SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::template BinnedTriangle<texFormat>>&
+	SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::getBinnedTriangles()
+{
+	if constexpr ( texFormat == CP_FORMAT::MONOCHROME_1BIT )
+	{
+		return m_BinnedTrianglesMonochrome;
+	}
+	else if constexpr ( texFormat == CP_FORMAT::RGBA_32BIT )
+	{
+		return m_BinnedTrianglesRGBA;
+	}
+	else if constexpr ( texFormat == CP_FORMAT::RGB_24BIT )
+	{
+		return m_BinnedTrianglesRGB;
+	}
+	else
+	{
+		return m_BinnedTrianglesBGR;
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat, typename ShaderProg>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::binTriangle (Face& face,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+{
+	this->template transformAndClipTriangle<texFormat, ShaderProg>( face, shaderData, [&](Face& clippedFace)
+		{
+			this->template binClippedTriangle<texFormat, ShaderProg>( clippedFace, shaderData );
+		} );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat, typename ShaderProg>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::binClippedTriangle (Face& clippedFace,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+{
+	std::vector<BinnedTriangle<texFormat>>& binnedTriangles = this->template getBinnedTriangles<texFormat>();
+
+	// screen space bounding box of the clipped face
+	float minX = clippedFace.vertices[0].vec.x();
+	float maxX = minX;
+	float minY = clippedFace.vertices[0].vec.y();
+	float maxY = minY;
+	for ( unsigned int vertNum = 1; vertNum < 3; vertNum++ )
+	{
+		minX = std::min( minX, clippedFace.vertices[vertNum].vec.x() );
+		maxX = std::max( maxX, clippedFace.vertices[vertNum].vec.x() );
+		minY = std::min( minY, clippedFace.vertices[vertNum].vec.y() );
+		maxY = std::max( maxY, clippedFace.vertices[vertNum].vec.y() );
+	}
+
+	const unsigned int tileXStart = static_cast<unsigned int>( clip(std::floor(minX * (width  - 1)), 0.0f, width  - 1) ) / m_TileSize;
+	const unsigned int tileXEnd   = static_cast<unsigned int>( clip(std::ceil (maxX * (width  - 1)), 0.0f, width  - 1) ) / m_TileSize;
+	const unsigned int tileYStart = static_cast<unsigned int>( clip(std::floor(minY * (height - 1)), 0.0f, height - 1) ) / m_TileSize;
+	const unsigned int tileYEnd   = static_cast<unsigned int>( clip(std::ceil (maxY * (height - 1)), 0.0f, height - 1) ) / m_TileSize;
+
+	const unsigned int triangleIndex = binnedTriangles.size();
+	binnedTriangles.push_back( BinnedTriangle<texFormat>{ clippedFace, shaderData,
+					&SoftwareGraphics3D::rasterizeInScissor<texFormat, ShaderProg> } );
+
+	for ( unsigned int tileY = tileYStart; tileY <= tileYEnd; tileY++ )
+	{
+		for ( unsigned int tileX = tileXStart; tileX <= tileXEnd; tileX++ )
+		{
+			m_TileBins[(tileY * m_NumTilesX) + tileX].push_back( TileEntry{texFormat, triangleIndex} );
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat, typename ShaderProg, typename RasterizeFunc>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::assembleMeshTriangles (const IndexedMesh& mesh,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, RasterizeFunc&& rasterizeFunc)
+{
+	Camera3D& camera = shaderData.camera;
+
+	ShaderProg::vShader( shaderData );
+
+	// cache entries from previous draws are invalidated by bumping the draw number instead of clearing the cache
+	if ( m_PostTransformCache.size() < mesh.vertices.size() )
+	{
+		m_PostTransformCache.resize( mesh.vertices.size(), TransformedVertex{Vertex(), Vertex(), false, 0} );
+	}
+	m_MeshDrawNum++;
+	if ( m_MeshDrawNum == 0 )
+	{
+		for ( TransformedVertex& transformedVertex : m_PostTransformCache )
+		{
+			transformedVertex.meshDrawNum = 0;
+		}
+		m_MeshDrawNum = 1;
+	}
+
+	auto getTransformedVertex = [&](unsigned int index) -> const TransformedVertex&
+		{
+			TransformedVertex& transformedVertex = m_PostTransformCache[index];
+			if ( transformedVertex.meshDrawNum != m_MeshDrawNum )
+			{
+				transformedVertex.meshDrawNum = m_MeshDrawNum;
+				transformedVertex.clipVertex = mesh.transformedVertex( index );
+				camera.multiplyByCameraMatrix( transformedVertex.clipVertex );
+				transformedVertex.insideView = transformedVertex.clipVertex.isInsideView();
+				if ( transformedVertex.insideView )
+				{
+					transformedVertex.screenVertex = transformedVertex.clipVertex;
+					camera.perspectiveDivide( transformedVertex.screenVertex );
+					camera.scaleXYToZeroToOne( transformedVertex.screenVertex );
+				}
+			}
+
+			return transformedVertex;
+		};
+
+	for ( unsigned int faceNum = 0; faceNum < mesh.numFaces(); faceNum++ )
+	{
+		const TransformedVertex& v1 = getTransformedVertex( mesh.indices[(faceNum * 3) + 0] );
+		const TransformedVertex& v2 = getTransformedVertex( mesh.indices[(faceNum * 3) + 1] );
+		const TransformedVertex& v3 = getTransformedVertex( mesh.indices[(faceNum * 3) + 2] );
+
+		if constexpr ( RENDER_STATS_ENABLED )
+		{
+			this->m_FrameStats.trianglesSubmitted++;
+		}
+
+		Face face{{ v1.clipVertex, v2.clipVertex, v3.clipVertex }};
+		if ( isBackFacing(face, camera) )
+		{
+			if constexpr ( RENDER_STATS_ENABLED )
+			{
+				this->m_FrameStats.trianglesBackFaceCulled++;
+			}
+
+			continue;
+		}
+
+		if ( v1.insideView && v2.insideView && v3.insideView )
+		{
+			if constexpr ( RENDER_STATS_ENABLED )
+			{
+				this->m_FrameStats.trianglesTriviallyAccepted++;
+			}
+
+			// the rasterizer works on the face in place, so it gets a copy of the cached vertices
+			Face screenFace{{ v1.screenVertex, v2.screenVertex, v3.screenVertex }};
+			rasterizeFunc( screenFace );
+
+			continue;
+		}
+
+		this->clipTriangle( face, camera, rasterizeFunc );
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::rasterizeBinnedTriangle (unsigned int triangleIndex,
+		ColorProfile<format>& colorProfile, const ScissorRect& scissor, DEPTH_PASS depthPass)
+{
+	const BinnedTriangle<texFormat>& binnedTriangle = this->template getBinnedTriangles<texFormat>()[triangleIndex];
+
+	// the face is converted to screen space during rasterization and the shader data may be written to by the shader,
+	// so each tile works on its own copies
+	Face face = binnedTriangle.face;
+	TriShaderData<texFormat, api, shaderPassDataSize> shaderData = binnedTriangle.shaderData;
+
+	( this->*binnedTriangle.rasterize )( face, shaderData, colorProfile, scissor, depthPass );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat, typename ShaderProg>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::rasterizeInScissor (Face& face,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, ColorProfile<format>& colorProfile, const ScissorRect& scissor,
+		DEPTH_PASS depthPass)
+{
+	switch ( depthPass )
+	{
+		case DEPTH_PASS::DEPTH_AND_COLOR:
+			SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+				renderInBoundsTriangle<texFormat, false, ShaderProg, DEPTH_PASS::DEPTH_AND_COLOR>( face, shaderData, m_DepthBuffer,
+						colorProfile, scissor );
+			break;
+		case DEPTH_PASS::DEPTH_ONLY:
+			SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+				renderInBoundsTriangle<texFormat, false, ShaderProg, DEPTH_PASS::DEPTH_ONLY>( face, shaderData, m_DepthBuffer,
+						colorProfile, scissor );
+			break;
+		case DEPTH_PASS::COLOR_ON_EQUAL_DEPTH:
+			SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+				renderInBoundsTriangle<texFormat, false, ShaderProg, DEPTH_PASS::COLOR_ON_EQUAL_DEPTH>( face, shaderData, m_DepthBuffer,
+						colorProfile, scissor );
+			break;
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::rasterizeTileBin (unsigned int tileNum,
+		ColorProfile<format>& colorProfile, const ScissorRect& scissor, DEPTH_PASS depthPass)
+{
+	for ( const TileEntry& tileEntry : m_TileBins[tileNum] )
+	{
+		switch ( tileEntry.texFormat )
+		{
+			case CP_FORMAT::MONOCHROME_1BIT:
+				this->template rasterizeBinnedTriangle<CP_FORMAT::MONOCHROME_1BIT>( tileEntry.triangleIndex, colorProfile, scissor, depthPass );
+				break;
+			case CP_FORMAT::RGBA_32BIT:
+				this->template rasterizeBinnedTriangle<CP_FORMAT::RGBA_32BIT>( tileEntry.triangleIndex, colorProfile, scissor, depthPass );
+				break;
+			case CP_FORMAT::RGB_24BIT:
+				this->template rasterizeBinnedTriangle<CP_FORMAT::RGB_24BIT>( tileEntry.triangleIndex, colorProfile, scissor, depthPass );
+				break;
+			case CP_FORMAT::BGR_24BIT:
+				this->template rasterizeBinnedTriangle<CP_FORMAT::BGR_24BIT>( tileEntry.triangleIndex, colorProfile, scissor, depthPass );
+				break;
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::rasterizeTiles()
+{
+	static_assert( m_TileSize % SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::m_FillTileSize == 0,
+			"the tile threads can't share fill tiles, since they mark them as damaged at the same time" );
+
+	// each worker uses its own color profile, since the shaded colors are set pixel by pixel
+	ColorProfile<format> colorProfile = m_ColorProfile;
+
+	for ( unsigned int tileNum = m_NextTile++; tileNum < m_NumTilesX * m_NumTilesY; tileNum = m_NextTile++ )
+	{
+		const int tileX = tileNum % m_NumTilesX;
+		const int tileY = tileNum / m_NumTilesX;
+		const ScissorRect& clipRect = this->m_ClipRect;
+		const ScissorRect scissor = {
+			std::max( tileX * static_cast<int>(m_TileSize), clipRect.xMin ),
+			std::max( tileY * static_cast<int>(m_TileSize), clipRect.yMin ),
+			std::min( (tileX + 1) * static_cast<int>(m_TileSize), clipRect.xMaxExclusive ),
+			std::min( (tileY + 1) * static_cast<int>(m_TileSize), clipRect.yMaxExclusive )
+		};
+		if ( scissor.xMin >= scissor.xMaxExclusive || scissor.yMin >= scissor.yMaxExclusive )
+		{
+			continue;
+		}
+
+		if ( m_DepthPrePass )
+		{
+			this->rasterizeTileBin( tileNum, colorProfile, scissor, DEPTH_PASS::DEPTH_ONLY );
+			this->rasterizeTileBin( tileNum, colorProfile, scissor, DEPTH_PASS::COLOR_ON_EQUAL_DEPTH );
+		}
+		else
+		{
+			this->rasterizeTileBin( tileNum, colorProfile, scissor, DEPTH_PASS::DEPTH_AND_COLOR );
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::startTileWorkers (unsigned int numWorkers)
+{
+	// only the thread calling flushTiles() touches the workers and the flush number outside of the mutex
+	while ( m_TileWorkers.size() < numWorkers )
+	{
+		m_TileWorkers.emplace_back( &SoftwareGraphics3D::runTileWorker, this, m_TileWorkers.size(), m_TileFlushNum );
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::runTileWorker (unsigned int workerNum,
+		unsigned int lastFlushNum)
+{
+	std::unique_lock<std::mutex> lock( m_TileWorkersMutex );
+	while ( true )
+	{
+		m_TileWorkersStart.wait( lock, [&]() { return m_StopTileWorkers || m_TileFlushNum != lastFlushNum; } );
+		if ( m_StopTileWorkers )
+		{
+			return;
+		}
+
+		// a flush can use fewer workers than were started for an earlier one
+		lastFlushNum = m_TileFlushNum;
+		if ( workerNum >= m_NumTileWorkersFlushing )
+		{
+			continue;
+		}
+
+		lock.unlock();
+		this->rasterizeTiles();
+		lock.lock();
+
+		m_NumTileWorkersBusy--;
+		if ( m_NumTileWorkersBusy == 0 )
+		{
+			m_TileWorkersDone.notify_one();
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::stopTileWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_TileWorkersMutex );
+		m_StopTileWorkers = true;
+	}
+	m_TileWorkersStart.notify_all();
+
+	for ( std::thread& worker : m_TileWorkers )
+	{
+		worker.join();
+	}
+	m_TileWorkers.clear();
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::flushTiles()
+{
+	if ( m_BinnedTrianglesMonochrome.empty() && m_BinnedTrianglesRGBA.empty() && m_BinnedTrianglesRGB.empty() && m_BinnedTrianglesBGR.empty() )
+	{
+		return;
+	}
+
+	// monochrome pixels share bytes, so if rows don't end on a byte boundary neighboring tiles can't be written concurrently
+	unsigned int numThreads = ( m_TiledRendering ) ? std::min( m_NumTileThreads, m_NumTilesX * m_NumTilesY ) : 1;
+	if ( format == CP_FORMAT::MONOCHROME_1BIT && (width % 8 != 0 || m_TileSize % 8 != 0) )
+	{
+		numThreads = 1;
+	}
+
+	// the calling thread rasterizes tiles as well
+	m_NextTile = 0;
+	const unsigned int numWorkers = numThreads - 1;
+	if ( numWorkers > 0 )
+	{
+		this->startTileWorkers( numWorkers );
+		{
+			std::lock_guard<std::mutex> lock( m_TileWorkersMutex );
+			m_NumTileWorkersFlushing = numWorkers;
+			m_NumTileWorkersBusy = numWorkers;
+			m_TileFlushNum++;
+		}
+		m_TileWorkersStart.notify_all();
+	}
+
+	this->rasterizeTiles();
+
+	if ( numWorkers > 0 )
+	{
+		std::unique_lock<std::mutex> lock( m_TileWorkersMutex );
+		m_TileWorkersDone.wait( lock, [this]() { return m_NumTileWorkersBusy == 0; } );
+	}
+
+	for ( std::vector<TileEntry>& tileBin : m_TileBins )
+	{
+		tileBin.clear();
+	}
+	m_BinnedTrianglesMonochrome.clear();
+	m_BinnedTrianglesRGBA.clear();
+	m_BinnedTrianglesRGB.clear();
+	m_BinnedTrianglesBGR.clear();
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api,  include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
+		TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData)
+{
+	if ( m_TiledRendering || m_DepthPrePass )
+	{
+		this->template binTriangle<CP_FORMAT::MONOCHROME_1BIT, FunctionPointerShaderProgram>( face, shaderData );
+		return;
+	}
+
+	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+		drawTriangleShadedHelper<CP_FORMAT::MONOCHROME_1BIT>( face, shaderData, m_DepthBuffer );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
+		TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData)
+{
+	if ( m_TiledRendering || m_DepthPrePass )
+	{
+		this->template binTriangle<CP_FORMAT::RGBA_32BIT, FunctionPointerShaderProgram>( face, shaderData );
+		return;
+	}
+
+	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+		drawTriangleShadedHelper<CP_FORMAT::RGBA_32BIT>( face, shaderData, m_DepthBuffer );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
+		TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData)
+{
+	if ( m_TiledRendering || m_DepthPrePass )
+	{
+		this->template binTriangle<CP_FORMAT::RGB_24BIT, FunctionPointerShaderProgram>( face, shaderData );
+		return;
+	}
+
+	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+		drawTriangleShadedHelper<CP_FORMAT::RGB_24BIT>( face, shaderData, m_DepthBuffer );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
+		TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData)
+{
+	if ( m_TiledRendering || m_DepthPrePass )
+	{
+		this->template binTriangle<CP_FORMAT::BGR_24BIT, FunctionPointerShaderProgram>( face, shaderData );
+		return;
+	}
+
+	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+		drawTriangleShadedHelper<CP_FORMAT::BGR_24BIT>( face, shaderData, m_DepthBuffer );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <typename ShaderProg, CP_FORMAT texFormat>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShaded (Face& face,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+{
+	if ( m_TiledRendering || m_DepthPrePass )
+	{
+		this->template binTriangle<texFormat, ShaderProg>( face, shaderData );
+		return;
+	}
+
+	SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+		drawTriangleShadedHelper<texFormat, false, ShaderProg>( face, shaderData, m_DepthBuffer );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::MONOCHROME_1BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->template drawMesh<FunctionPointerShaderProgram>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::RGBA_32BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->template drawMesh<FunctionPointerShaderProgram>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::RGB_24BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->template drawMesh<FunctionPointerShaderProgram>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<CP_FORMAT::BGR_24BIT, api, shaderPassDataSize>& shaderData)
+{
+	this->template drawMesh<FunctionPointerShaderProgram>( mesh, shaderData );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <typename ShaderProg, CP_FORMAT texFormat>
+void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawMesh (const IndexedMesh& mesh,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData)
+{
+	if ( m_TiledRendering || m_DepthPrePass )
+	{
+		this->template assembleMeshTriangles<texFormat, ShaderProg>( mesh, shaderData, [&](Face& clippedFace)
+			{
+				this->template binClippedTriangle<texFormat, ShaderProg>( clippedFace, shaderData );
+			} );
+		return;
+	}
+
+	// get previous color, since we'll want to set it back when we're done with the shading colors
+	const Color previousColor = m_ColorProfile.template getColor<format>();
+
+	this->template assembleMeshTriangles<texFormat, ShaderProg>( mesh, shaderData, [&](Face& clippedFace)
+		{
+			SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
+				renderInBoundsTriangle<texFormat, false, ShaderProg>( clippedFace, shaderData, m_DepthBuffer, m_ColorProfile,
+						this->m_ClipRect );
+		} );
+
+	// set the previously used color back since we're done with the gradients
+	m_ColorProfile.setColor( previousColor );
+}
+
+inline float calcIncr(const Vector<3>& values, float xy1, float xy2, float xy3, float oneOverdXY)
+{
+	const float retVal = ( ((values.at(1) - values.at(2)) * (xy1 - xy3)) - ((values.at(0) - values.at(2)) * (xy2 - xy3)) ) * oneOverdXY;
+	return ( retVal > 100000.0f || retVal < -100000.0f ) ? 0.0f : retVal;
+}
+
+inline float saturate (float val)
+{
+	if ( val > 1.0f ) return 1.0f; else if ( val < 0.0f ) return 0.0f; else return val;
+}
+
+// interpolated values for a batch of horizontally adjacent pixels in a span
+struct FragmentBatch
+{
+	alignas(32) float depth[FRAGMENT_BATCH_SIZE];
+	alignas(32) float texCoordX[FRAGMENT_BATCH_SIZE]; // already perspective corrected
+	alignas(32) float texCoordY[FRAGMENT_BATCH_SIZE];
+	alignas(32) float lightAmnt[FRAGMENT_BATCH_SIZE];
+	Color colors[FRAGMENT_BATCH_SIZE]; // output of the batch fragment shader
+};
+
+// if PERSPECTIVE_SUBDIVISION is defined (to a multiple of FRAGMENT_BATCH_SIZE, typically 8 or 16), tex coords are only perspective
+// corrected at the edges of each PERSPECTIVE_SUBDIVISION pixel wide column of the screen (clamped to the span) and linearly
+// interpolated in between, instead of taking a reciprocal per pixel. See perspectiveSubdivisionErrorBound for the resulting error
+#ifdef PERSPECTIVE_SUBDIVISION
+constexpr unsigned int PERSPECTIVE_SUBDIVISION_LENGTH = PERSPECTIVE_SUBDIVISION;
+static_assert( PERSPECTIVE_SUBDIVISION_LENGTH % FRAGMENT_BATCH_SIZE == 0, "subdivisions must be made up of whole fragment batches" );
+#else
+constexpr unsigned int PERSPECTIVE_SUBDIVISION_LENGTH = 0;
+#endif
+
+// linearly interpolating a perspective correct tex coord between texCoordStart and texCoordEnd, where the interpolated 1/w is persStart
+// and persEnd, is off by t * (1 - t) * (texCoordEnd - texCoordStart) * (persEnd - persStart) / pers(t) at t along the way. This is an
+// upper bound on that, not its exact max, since t * (1 - t) is bounded by 1/4 and pers(t) by the smaller end separately. So the error
+// of any subdivided tex coord is at most this (plus float rounding)
+inline float perspectiveSubdivisionErrorBound (float texCoordStart, float texCoordEnd, float persStart, float persEnd)
+{
+	return 0.25f * std::abs( (texCoordEnd - texCoordStart) * (persEnd - persStart) ) / std::min( std::abs(persStart), std::abs(persEnd) );
+}
+
+// fills the batch with the values of the pixels at offset, offset + 1, ..., offset + FRAGMENT_BATCH_SIZE - 1 from the span start.
+// depth is computed the same way whether or not depthOnly is set, so that a depth pre-pass can be matched exactly. If perspectiveCorrect
+// isn't set the tex coords are already perspective corrected, so they're interpolated linearly and pers is ignored
+template <bool depthOnly = false, bool perspectiveCorrect = true>
+inline void interpolateFragmentBatch (FragmentBatch& batch, float offset, float depthStart, float depthIncr, float texXStart, float texXIncr,
+					float texYStart, float texYIncr, float persStart, float persIncr, float lightStart, float lightIncr)
+{
+#if defined(__AVX__)
+	const __m256 offsets = _mm256_add_ps( _mm256_set1_ps(offset), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f) );
+	_mm256_store_ps( batch.depth, _mm256_add_ps(_mm256_set1_ps(depthStart), _mm256_mul_ps(offsets, _mm256_set1_ps(depthIncr))) );
+	if constexpr ( depthOnly ) return;
+
+	const __m256 texX = _mm256_add_ps( _mm256_set1_ps(texXStart), _mm256_mul_ps(offsets, _mm256_set1_ps(texXIncr)) );
+	const __m256 texY = _mm256_add_ps( _mm256_set1_ps(texYStart), _mm256_mul_ps(offsets, _mm256_set1_ps(texYIncr)) );
+	if constexpr ( perspectiveCorrect )
+	{
+		const __m256 pers = _mm256_add_ps( _mm256_set1_ps(persStart), _mm256_mul_ps(offsets, _mm256_set1_ps(persIncr)) );
+		const __m256 perspOffset = _mm256_div_ps( _mm256_set1_ps(1.0f), pers );
+		_mm256_store_ps( batch.texCoordX, _mm256_mul_ps(texX, perspOffset) );
+		_mm256_store_ps( batch.texCoordY, _mm256_mul_ps(texY, perspOffset) );
+	}
+	else
+	{
+		_mm256_store_ps( batch.texCoordX, texX );
+		_mm256_store_ps( batch.texCoordY, texY );
+	}
+	_mm256_store_ps( batch.lightAmnt, _mm256_add_ps(_mm256_set1_ps(lightStart), _mm256_mul_ps(offsets, _mm256_set1_ps(lightIncr))) );
+#elif defined(__SSE2__)
+	for ( unsigned int lane = 0; lane < FRAGMENT_BATCH_SIZE; lane += 4 )
+	{
+		const __m128 offsets = _mm_add_ps( _mm_set1_ps(offset + lane), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f) );
+		_mm_store_ps( &batch.depth[lane], _mm_add_ps(_mm_set1_ps(depthStart), _mm_mul_ps(offsets, _mm_set1_ps(depthIncr))) );
+		if constexpr ( depthOnly ) continue;
+
+		const __m128 texX = _mm_add_ps( _mm_set1_ps(texXStart), _mm_mul_ps(offsets, _mm_set1_ps(texXIncr)) );
+		const __m128 texY = _mm_add_ps( _mm_set1_ps(texYStart), _mm_mul_ps(offsets, _mm_set1_ps(texYIncr)) );
+		if constexpr ( perspectiveCorrect )
+		{
+			const __m128 pers = _mm_add_ps( _mm_set1_ps(persStart), _mm_mul_ps(offsets, _mm_set1_ps(persIncr)) );
+			const __m128 perspOffset = _mm_div_ps( _mm_set1_ps(1.0f), pers );
+			_mm_store_ps( &batch.texCoordX[lane], _mm_mul_ps(texX, perspOffset) );
+			_mm_store_ps( &batch.texCoordY[lane], _mm_mul_ps(texY, perspOffset) );
+		}
+		else
+		{
+			_mm_store_ps( &batch.texCoordX[lane], texX );
+			_mm_store_ps( &batch.texCoordY[lane], texY );
+		}
+		_mm_store_ps( &batch.lightAmnt[lane], _mm_add_ps(_mm_set1_ps(lightStart), _mm_mul_ps(offsets, _mm_set1_ps(lightIncr))) );
+	}
+#else
+	for ( unsigned int lane = 0; lane < FRAGMENT_BATCH_SIZE; lane++ )
+	{
+		const float laneOffset = offset + lane;
+		batch.depth[lane] = depthStart + ( laneOffset * depthIncr );
+		if constexpr ( depthOnly ) continue;
+
+		const float perspOffset = ( perspectiveCorrect ) ? 1.0f / ( persStart + (laneOffset * persIncr) ) : 1.0f;
+		batch.texCoordX[lane] = ( texXStart + (laneOffset * texXIncr) ) * perspOffset;
+		batch.texCoordY[lane] = ( texYStart + (laneOffset * texYIncr) ) * perspOffset;
+		batch.lightAmnt[lane] = lightStart + ( laneOffset * lightIncr );
+	}
+#endif
+}
+
+// returns a bitmask with a bit set for each of the first numPixels pixels starting at pixel that pass the depth test, which is either
+// stored >= depth or stored == depth if depthEqual is set
+template <bool depthEqual = false, typename DepthBufferType>
+inline unsigned int depthTestFragmentBatch (const FragmentBatch& batch, const DepthBufferType& depthBuffer, unsigned int pixel,
+						unsigned int numPixels)
+{
+	if constexpr ( DepthBufferType::FORMAT == DEPTH_FORMAT::FLOAT_32BIT )
+	{
+		const float* depthBufferValues = depthBuffer.getFloatDepths( pixel );
+#if defined(__AVX__)
+		// only load a full batch from the depth buffer, since a partial batch may be at the end of the buffer
+		if ( numPixels == FRAGMENT_BATCH_SIZE )
+		{
+			constexpr int comparison = ( depthEqual ) ? _CMP_EQ_OQ : _CMP_GE_OQ;
+			return _mm256_movemask_ps( _mm256_cmp_ps(_mm256_loadu_ps(depthBufferValues), _mm256_load_ps(batch.depth), comparison) );
+		}
+#elif defined(__SSE2__)
+		if ( numPixels == FRAGMENT_BATCH_SIZE )
+		{
+			if constexpr ( depthEqual )
+			{
+				const unsigned int lowMask  = _mm_movemask_ps( _mm_cmpeq_ps(_mm_loadu_ps(&depthBufferValues[0]), _mm_load_ps(&batch.depth[0])) );
+				const unsigned int highMask = _mm_movemask_ps( _mm_cmpeq_ps(_mm_loadu_ps(&depthBufferValues[4]), _mm_load_ps(&batch.depth[4])) );
+				return lowMask | ( highMask << 4 );
+			}
+			else
+			{
+				const unsigned int lowMask  = _mm_movemask_ps( _mm_cmpge_ps(_mm_loadu_ps(&depthBufferValues[0]), _mm_load_ps(&batch.depth[0])) );
+				const unsigned int highMask = _mm_movemask_ps( _mm_cmpge_ps(_mm_loadu_ps(&depthBufferValues[4]), _mm_load_ps(&batch.depth[4])) );
+				return lowMask | ( highMask << 4 );
+			}
+		}
+#endif
+	}
+
+	// the normalized formats compare in their own precision, so that a depth pre-pass and an equal depth pass agree exactly
+	unsigned int mask = 0;
+	for ( unsigned int lane = 0; lane < numPixels; lane++ )
+	{
+		const typename DepthBufferType::DepthValue stored = depthBuffer.get( pixel + lane );
+		const typename DepthBufferType::DepthValue depth = DepthBufferType::toDepthValue( batch.depth[lane] );
+		if ( (depthEqual) ? stored == depth : stored >= depth )
+		{
+			mask |= ( 1u << lane );
+		}
+	}
+
+	return mask;
+}
 
-		const float oneOverPixelStride = 1.0f / ( static_cast<float>( rightX ) - static_cast<float>( leftX ) );
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize,
+	CP_FORMAT texFormat, bool withTransparency, typename ShaderProg, DEPTH_PASS depthPass>
+inline void renderScanlinesHelper (int startRow, int endRowExclusive, float x1, float y1, RasterEdge& leftEdge, RasterEdge& rightEdge,
+					float v1PerspMul, float v1Depth, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, Color& currentColor, float texCoordX1,
+					float texCoordY1, float texCoordXXIncr, float texCoordXYIncr, float texCoordYXIncr, float texCoordYYIncr,
+					float perspXIncr, float perspYIncr, float depthXIncr, float depthYIncr, float v1LightAmnt,
+					float lightAmntXIncr, float lightAmntYIncr, DepthBuffer<width, height>& depthBuffer,
+					ColorProfile<format>& colorProfile, FrameBufferFixed<width, height, format, api>& fb,
+					const ScissorRect& scissor, RenderStats& renderStats, const HeatmapTarget& heatmap)
+{
+	// rows above the scissor rect are skipped in one go, which leaves the edges exactly where stepping through them would, so that
+	// spans below match an unscissored render exactly
+	const int firstRow = std::min( std::max(startRow, scissor.yMin), endRowExclusive );
+	leftEdge.advance( firstRow - startRow );
+	rightEdge.advance( firstRow - startRow );
+
+	for ( int row = firstRow; row < endRowExclusive && row < scissor.yMaxExclusive; row++ )
+	{
+		// values are interpolated across the whole span, so that a scissored span shades the same as an unscissored one
+		const int spanLeftX  = leftEdge.x();
+		const int spanRightX = rightEdge.x();
+		const int leftX  = std::max( spanLeftX,  scissor.xMin );
+		const int rightX = std::min( spanRightX, scissor.xMaxExclusive );
+
+		const unsigned int tempXY1 = ( (row * width) + leftX );
+
+		// offsetting float values from origin for Incr values
+		const float rowF = static_cast<float>( row ) - y1;
+		const float leftXF  = static_cast<float>( spanLeftX ) - x1;
+		const float rightXF = static_cast<float>( spanRightX ) - x1;
+
+		const float oneOverPixelStride = 1.0f / ( static_cast<float>( spanRightX ) - static_cast<float>( spanLeftX ) );
 		const float depthStart = v1Depth + ( depthYIncr * (rowF) ) + ( depthXIncr * (leftXF ) );
 		const float depthEnd   = v1Depth + ( depthYIncr * (rowF) ) + ( depthXIncr * (rightXF) );
 		const float texXStart  = ( texCoordX1 * v1PerspMul ) + ( texCoordXYIncr * (rowF) ) + ( texCoordXXIncr * (leftXF ) );
@@ -690,41 +2170,169 @@ inline void renderScanlinesHelper (int startRow, int endRowExclusive, float x1,
 		const float texYIncr   = ( texYEnd - texYStart ) * oneOverPixelStride;
 
 		const float lightIncr  = ( lightEnd - lightStart ) * oneOverPixelStride;
-		float depth = depthStart;
-		float texX  = texXStart;
-		float texY  = texYStart;
-		float pers  = persStart;
-		float light = lightStart;
 
-		for ( unsigned int pixel = tempXY1; pixel < tempXY2; pixel += 1 )
+		// shade the span in batches of pixels, aligned so that each batch is inside of a single depth buffer tile
+		static_assert( FRAGMENT_BATCH_SIZE == DepthBuffer<width, height>::TILE_SIZE, "batches must line up with depth tiles" );
+		const unsigned int tileY = row / DepthBuffer<width, height>::TILE_SIZE;
+		const bool useBatch = useFShaderBatch<ShaderProg>( shaderData );
+		FragmentBatch batch;
+
+		// the current perspective subdivision, in offsets from the span start, and its perspective correct tex coords at each end
+		int subdivStart = -1;
+		int subdivEnd = -1;
+		float subdivTexXStart = 0.0f, subdivTexYStart = 0.0f, subdivTexXEnd = 0.0f, subdivTexYEnd = 0.0f;
+		auto perspectiveCorrectTexCoords = [&](int offset, float& texXOut, float& texYOut)
+			{
+				const float offsetF = static_cast<float>( offset );
+				const float perspOffset = 1.0f / ( persStart + (offsetF * persIncr) );
+				texXOut = ( texXStart + (offsetF * texXIncr) ) * perspOffset;
+				texYOut = ( texYStart + (offsetF * texYIncr) ) * perspOffset;
+			};
+
+		for ( int batchX = leftX; batchX < rightX; )
 		{
+			const unsigned int batchPixel = tempXY1 + ( batchX - leftX );
+			const unsigned int tileX = batchX / FRAGMENT_BATCH_SIZE;
+			const unsigned int numPixels = std::min( (tileX + 1) * FRAGMENT_BATCH_SIZE, static_cast<unsigned int>(rightX) ) - batchX;
+			const float batchOffset = static_cast<float>( batchX - spanLeftX );
+			batchX += numPixels;
+
 			if constexpr ( include3D )
 			{
-				if ( depthBuffer[pixel] >= depth )
+				// depth is linear across the span, so the nearest pixel of the batch is at one of its ends
+				const float firstDepth = depthStart + ( batchOffset * depthIncr );
+				const float lastDepth  = depthStart + ( (batchOffset + static_cast<float>(numPixels - 1)) * depthIncr );
+				if ( depthBuffer.isTileOccluded(tileX, tileY, std::min(firstDepth, lastDepth)) )
 				{
-					const float perspOffset = 1.0f / pers;
-					const float texCoordX = texX * perspOffset;
-					const float texCoordY = texY * perspOffset;
-					( *shaderData.fShader )( currentColor, shaderData, 0.0f, 0.0f, 0.0f, texCoordX, texCoordY, light );
-					colorProfile.setColor( currentColor );
-					if constexpr ( withTransparency )
+					if constexpr ( RENDER_STATS_ENABLED && depthPass != DEPTH_PASS::DEPTH_ONLY )
 					{
-						colorProfile.template putPixelWithAlphaBlending<width, height>( fb.getPixels(), pixel );
+						renderStats.pixelsOccluded += numPixels;
+					}
+
+					continue;
+				}
+			}
+
+			if constexpr ( PERSPECTIVE_SUBDIVISION_LENGTH != 0 && depthPass != DEPTH_PASS::DEPTH_ONLY )
+			{
+				// subdivisions are aligned to the screen instead of the span start so that they're the same in every tile, and since
+				// batches are aligned the same way each batch is inside of a single subdivision
+				const int batchSubdivX = ( (batchX - numPixels) / static_cast<int>(PERSPECTIVE_SUBDIVISION_LENGTH) )
+								* static_cast<int>( PERSPECTIVE_SUBDIVISION_LENGTH );
+				const int batchSubdivStart = std::max( batchSubdivX, spanLeftX ) - spanLeftX;
+				const int batchSubdivEnd = std::min( batchSubdivX + static_cast<int>(PERSPECTIVE_SUBDIVISION_LENGTH), spanRightX - 1 )
+								- spanLeftX;
+				if ( batchSubdivStart != subdivStart )
+				{
+					// neighboring subdivisions share an end
+					if ( batchSubdivStart == subdivEnd )
+					{
+						subdivTexXStart = subdivTexXEnd;
+						subdivTexYStart = subdivTexYEnd;
 					}
 					else
 					{
-						colorProfile.template putPixel<width, height>( fb.getPixels(), pixel );
-						depthBuffer[pixel] = depth;
+						perspectiveCorrectTexCoords( batchSubdivStart, subdivTexXStart, subdivTexYStart );
 					}
+					perspectiveCorrectTexCoords( batchSubdivEnd, subdivTexXEnd, subdivTexYEnd );
+					subdivStart = batchSubdivStart;
+					subdivEnd = batchSubdivEnd;
 				}
+
+				const float oneOverSubdivLength = ( subdivEnd > subdivStart ) ? 1.0f / static_cast<float>( subdivEnd - subdivStart ) : 0.0f;
+				const float subdivTexXIncr = ( subdivTexXEnd - subdivTexXStart ) * oneOverSubdivLength;
+				const float subdivTexYIncr = ( subdivTexYEnd - subdivTexYStart ) * oneOverSubdivLength;
+				const float subdivStartF = static_cast<float>( subdivStart );
+				interpolateFragmentBatch<false, false>( batch, batchOffset, depthStart, depthIncr,
+						subdivTexXStart - (subdivStartF * subdivTexXIncr), subdivTexXIncr,
+						subdivTexYStart - (subdivStartF * subdivTexYIncr), subdivTexYIncr, 1.0f, 0.0f, lightStart, lightIncr );
 			}
 			else
 			{
-				const float perspOffset = 1.0f / pers;
-				const float texCoordX = texX * perspOffset;
-				const float texCoordY = texY * perspOffset;
-				( *shaderData.fShader )( currentColor, shaderData, 0.0f, 0.0f, 0.0f, texCoordX, texCoordY, light );
-				colorProfile.setColor( currentColor );
+				interpolateFragmentBatch<depthPass == DEPTH_PASS::DEPTH_ONLY>( batch, batchOffset, depthStart, depthIncr, texXStart, texXIncr,
+						texYStart, texYIncr, persStart, persIncr, lightStart, lightIncr );
+			}
+
+			unsigned int mask = ( 1u << numPixels ) - 1;
+			if constexpr ( include3D )
+			{
+				depthBuffer.resolveTile( tileX, tileY );
+				mask &= depthTestFragmentBatch<depthPass == DEPTH_PASS::COLOR_ON_EQUAL_DEPTH>( batch, depthBuffer, batchPixel, numPixels );
+
+				// the depth only pass tests the same pixels again, so they're only counted once in the color pass
+				if constexpr ( RENDER_STATS_ENABLED && depthPass != DEPTH_PASS::DEPTH_ONLY )
+				{
+					const unsigned int numPassed = std::bitset<FRAGMENT_BATCH_SIZE>( mask ).count();
+					renderStats.depthTestsPassed += numPassed;
+					renderStats.depthTestsFailed += numPixels - numPassed;
+				}
+			}
+
+			if ( mask == 0 )
+			{
+				continue;
+			}
+
+			if constexpr ( include3D && ! withTransparency && depthPass != DEPTH_PASS::COLOR_ON_EQUAL_DEPTH )
+			{
+				depthBuffer.markTileDirty( tileX, tileY );
+			}
+
+			if constexpr ( depthPass == DEPTH_PASS::DEPTH_ONLY )
+			{
+				for ( unsigned int lane = 0; lane < numPixels; lane++ )
+				{
+					if ( mask & (1u << lane) )
+					{
+						depthBuffer.set( batchPixel + lane, depthBuffer.toDepthValue(batch.depth[lane]) );
+					}
+				}
+
+				continue;
+			}
+
+			if constexpr ( RENDER_STATS_ENABLED )
+			{
+				// sprites are the only triangles drawn with transparency
+				constexpr RENDER_PRIMITIVE primitive = ( withTransparency ) ? RENDER_PRIMITIVE::SPRITE : RENDER_PRIMITIVE::TRIANGLE_SHADED;
+				const unsigned int numShaded = std::bitset<FRAGMENT_BATCH_SIZE>( mask ).count();
+				renderStats.fragmentShaderInvocations += numShaded;
+				renderStats.getPixelsWritten( primitive ) += numShaded;
+			}
+
+			std::chrono::steady_clock::time_point shadeStart;
+			if constexpr ( RENDER_HEATMAP_ENABLED )
+			{
+				if ( heatmap.mode == HEATMAP_MODE::SHADER_COST )
+				{
+					shadeStart = std::chrono::steady_clock::now();
+				}
+			}
+
+			if ( useBatch )
+			{
+				ShaderProg::fShaderBatch( batch.colors, shaderData, batch.texCoordX, batch.texCoordY, batch.lightAmnt, mask );
+			}
+
+			for ( unsigned int lane = 0; lane < numPixels; lane++ )
+			{
+				if ( ! (mask & (1u << lane)) )
+				{
+					continue;
+				}
+
+				if ( useBatch )
+				{
+					colorProfile.setColor( batch.colors[lane] );
+				}
+				else
+				{
+					ShaderProg::fShader( currentColor, shaderData, 0.0f, 0.0f, 0.0f, batch.texCoordX[lane], batch.texCoordY[lane],
+									batch.lightAmnt[lane] );
+					colorProfile.setColor( currentColor );
+				}
+
+				const unsigned int pixel = batchPixel + lane;
 				if constexpr ( withTransparency )
 				{
 					colorProfile.template putPixelWithAlphaBlending<width, height>( fb.getPixels(), pixel );
@@ -732,42 +2340,65 @@ inline void renderScanlinesHelper (int startRow, int endRowExclusive, float x1,
 				else
 				{
 					colorProfile.template putPixel<width, height>( fb.getPixels(), pixel );
+
+					if constexpr ( include3D && depthPass == DEPTH_PASS::DEPTH_AND_COLOR )
+					{
+						depthBuffer.set( pixel, depthBuffer.toDepthValue(batch.depth[lane]) );
+					}
 				}
 			}
 
-			depth += depthIncr;
-			texX  += texXIncr;
-			texY  += texYIncr;
-			pers  += persIncr;
-			light += lightIncr;
+			if constexpr ( RENDER_HEATMAP_ENABLED )
+			{
+				if ( heatmap.counts != nullptr )
+				{
+					// the time spent on the batch is split evenly between its shaded pixels
+					uint32_t heat = 1;
+					if ( heatmap.mode == HEATMAP_MODE::SHADER_COST )
+					{
+						const uint32_t ticks = ( std::chrono::steady_clock::now() - shadeStart ).count();
+						heat = std::max( ticks / static_cast<uint32_t>(std::bitset<FRAGMENT_BATCH_SIZE>(mask).count()), 1u );
+					}
+
+					for ( unsigned int lane = 0; lane < numPixels; lane++ )
+					{
+						if ( mask & (1u << lane) )
+						{
+							heatmap.counts[batchPixel + lane] += heat;
+						}
+					}
+				}
+			}
 		}
 
-		// increment accumulators
-		xLeftAccumulator  += xLeftIncr;
-		xRightAccumulator += xRightIncr;
+		// step edges
+		leftEdge.step();
+		rightEdge.step();
 	}
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-template <CP_FORMAT texFormat, bool withTransparency>
+template <CP_FORMAT texFormat, bool withTransparency, typename ShaderProg, DEPTH_PASS depthPass>
 inline void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::renderScanlines (int startRow, int endRowExclusive,
-		float x1, float y1, float& xLeftAccumulator, float& xRightAccumulator, float v1PerspMul, float v1Depth, float xLeftIncr,
-		float xRightIncr, TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, Color& currentColor, float texCoordX1,
+		float x1, float y1, RasterEdge& leftEdge, RasterEdge& rightEdge, float v1PerspMul, float v1Depth,
+		TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, Color& currentColor, float texCoordX1,
 		float texCoordY1, float texCoordXXIncr, float texCoordXYIncr, float texCoordYXIncr, float texCoordYYIncr, float perspXIncr,
 		float perspYIncr, float depthXIncr, float depthYIncr, float v1LightAmnt, float lightAmntXIncr, float lightAmntYIncr,
-		std::array<float, width * height>& depthBuffer, int leftHanded)
+		DepthBuffer<width, height>& depthBuffer, ColorProfile<format>& colorProfile, const ScissorRect& scissor, RenderStats& renderStats,
+		const HeatmapTarget& heatmap)
 {
-	renderScanlinesHelper<width, height, format, api, include3D, shaderPassDataSize, texFormat, withTransparency>(
-			startRow, endRowExclusive, x1, y1, xLeftAccumulator, xRightAccumulator, v1PerspMul, v1Depth, xLeftIncr,
-			xRightIncr, shaderData, currentColor, texCoordX1, texCoordY1, texCoordXXIncr, texCoordXYIncr, texCoordYXIncr,
-			texCoordYYIncr, perspXIncr, perspYIncr, depthXIncr, depthYIncr, v1LightAmnt, lightAmntXIncr, lightAmntYIncr,
-			depthBuffer, m_ColorProfile, m_FB, leftHanded );
+	renderScanlinesHelper<width, height, format, api, include3D, shaderPassDataSize, texFormat, withTransparency, ShaderProg, depthPass>(
+			startRow, endRowExclusive, x1, y1, leftEdge, rightEdge, v1PerspMul, v1Depth, shaderData, currentColor,
+			texCoordX1, texCoordY1, texCoordXXIncr, texCoordXYIncr, texCoordYXIncr, texCoordYYIncr, perspXIncr, perspYIncr,
+			depthXIncr, depthYIncr, v1LightAmnt, lightAmntXIncr, lightAmntYIncr, depthBuffer, colorProfile, m_FB, scissor, renderStats,
+			heatmap );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-template <CP_FORMAT texFormat, bool withTransparency>
+template <CP_FORMAT texFormat, bool withTransparency, typename ShaderProg, DEPTH_PASS depthPass>
 void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::renderInBoundsTriangle (Face& face,
-			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, std::array<float, width * height>& depthBuffer)
+			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, DepthBuffer<width, height>& depthBuffer,
+			ColorProfile<format>& colorProfile, const ScissorRect& scissor)
 {
 	// offset to screen space
 	face.vertices[0].vec.x() *= (width  - 1);
@@ -786,40 +2417,40 @@ void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataS
 	const float x3 = face.vertices[2].vec.x();
 	const float y3 = face.vertices[2].vec.y();
 
-	const int y1Ceil = std::ceil( y1 );
-	const int y2Ceil = std::ceil( y2 );
-	const int y3Ceil = std::ceil( y3 );
+	const int y1Ceil = RasterEdge::ceilRow( y1 );
+	const int y3Ceil = RasterEdge::ceilRow( y3 );
 
-	// floats for incrementing xLeftAccumulator and xRightAccumulator
-	float xLeftIncrTop     = ( x2 - x1 ) / ( y2 - y1 );
-	float xRightIncrTop    = ( x3 - x1 ) / ( y3 - y1 );
-	float xLeftIncrBottom  = ( x3 - x2 ) / ( y3 - y2 );
-	float xRightIncrBottom = ( x3 - x1 ) / ( y3 - y1 );
-
-	// get handedness by calculating area by getting cross product of vectors of lines 1 and 2
-	const float vec1X = x3 - x1;
-	const float vec1Y = y3 - y1;
-	const float vec2X = x2 - x1;
-	const float vec2Y = y2 - y1;
-
-	const float area = ( vec1X * vec2Y ) - ( vec2X * vec1Y );
-	const int leftHanded = ( area >= 0 ) ? 1 : 0;
+	// pixels the triangle can cover, used for hierarchical depth rejection and updating
+	const int boundsXMin = std::max( static_cast<int>(std::floor(std::min({x1, x2, x3}))), scissor.xMin );
+	const int boundsXMaxExclusive = std::min( static_cast<int>(std::ceil(std::max({x1, x2, x3}))) + 1, scissor.xMaxExclusive );
+	const int boundsYMin = std::max( y1Ceil, scissor.yMin );
+	const int boundsYMaxExclusive = std::min( y3Ceil, scissor.yMaxExclusive );
+	if ( boundsXMin >= boundsXMaxExclusive || boundsYMin >= boundsYMaxExclusive )
+	{
+		return;
+	}
 
-	// depending on the position of the vertices, we need to swap increments
-	if ( leftHanded == 0 )
+	if constexpr ( include3D )
 	{
-		float tempIncr = xLeftIncrTop;
-		xLeftIncrTop = xRightIncrTop;
-		xRightIncrTop = tempIncr;
+		// depth is linear across the triangle, so the nearest point of the triangle is one of its vertices
+		const float minDepth = std::min( {face.vertices[0].vec.z(), face.vertices[1].vec.z(), face.vertices[2].vec.z()} );
+		if ( depthBuffer.isOccluded(boundsXMin, boundsYMin, boundsXMaxExclusive, boundsYMaxExclusive, minDepth) )
+		{
+			if constexpr ( RENDER_STATS_ENABLED )
+			{
+				RenderStats renderStats;
+				renderStats.trianglesOccluded++;
+				this->addRenderStats( renderStats );
+			}
 
-		tempIncr = xLeftIncrBottom;
-		xLeftIncrBottom = xRightIncrBottom;
-		xRightIncrBottom = tempIncr;
+			return;
+		}
 	}
 
-	// floats for x-intercepts (assuming the top of the triangle is pointed for now)
-	float xLeftAccumulator  = x1 + ( (static_cast<float>(y1Ceil) - y1) * xLeftIncrTop );
-	float xRightAccumulator = x1 + ( (static_cast<float>(y1Ceil) - y1) * xRightIncrTop );
+	if constexpr ( depthPass != DEPTH_PASS::DEPTH_ONLY )
+	{
+		this->resolvePendingFill( boundsXMin, boundsYMin, boundsXMaxExclusive, boundsYMaxExclusive, colorProfile );
+	}
 
 	// get vertex values for gradient calculations
 	const float texCoordX1 = face.vertices[0].texCoords.x();
@@ -859,61 +2490,105 @@ void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataS
 	const float lightAmntYIncr = calcIncr( lightAmnts, x1, x2, x3, oneOverdY );
 	// TODO we actually just want to interpolate the normals, for vertex-shaded lighting we can calculate in the vertex shader and pass down
 
-	Color currentColor;
+	Color currentColor;
+	RenderStats renderStats;
+	const HeatmapTarget heatmap = this->getHeatmapTarget();
+
+	walkTriangleEdges( x1, y1, x2, y2, x3, y3, [&](int startRow, int endRowExclusive, RasterEdge& leftEdge, RasterEdge& rightEdge)
+		{
+			renderScanlines<texFormat, withTransparency, ShaderProg, depthPass>( startRow, endRowExclusive, x1, y1, leftEdge, rightEdge,
+				v1PerspMul, v1Depth, shaderData, currentColor, texCoordX1, texCoordY1, texCoordXXIncr, texCoordXYIncr, texCoordYXIncr,
+				texCoordYYIncr, perspXIncr, perspYIncr, depthXIncr, depthYIncr, v1LightAmnt, lightAmntXIncr, lightAmntYIncr,
+				depthBuffer, colorProfile, scissor, renderStats, heatmap );
+		} );
+
+	this->addRenderStats( renderStats );
+
+	if constexpr ( include3D && ! withTransparency && depthPass != DEPTH_PASS::COLOR_ON_EQUAL_DEPTH )
+	{
+		depthBuffer.updateTiles( boundsXMin, boundsYMin, boundsXMaxExclusive, boundsYMaxExclusive );
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <CP_FORMAT texFormat, bool withTransparency, typename ShaderProg>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShadedHelper (Face& face,
+			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, DepthBuffer<width, height>& depthBuffer)
+{
+	// get previous color, since we'll want to set it back when we're done with the shading colors
+	const Color previousColor = m_ColorProfile.template getColor<format>();
+
+	this->template transformAndClipTriangle<texFormat, ShaderProg>( face, shaderData, [&](Face& clippedFace)
+		{
+			this->template renderInBoundsTriangle<texFormat, withTransparency, ShaderProg>( clippedFace, shaderData, depthBuffer, m_ColorProfile,
+					m_ClipRect );
+		} );
+
+	// set the previously used color back since we're done with the gradients
+	m_ColorProfile.setColor( previousColor );
+}
 
-	// render up until the second vertice
-	renderScanlines<texFormat, withTransparency>( y1Ceil, y2Ceil, x1, y1, xLeftAccumulator, xRightAccumulator, v1PerspMul,
-		v1Depth, xLeftIncrTop, xRightIncrTop, shaderData, currentColor, texCoordX1, texCoordY1, texCoordXXIncr, texCoordXYIncr,
-		texCoordYXIncr, texCoordYYIncr, perspXIncr, perspYIncr, depthXIncr, depthYIncr, v1LightAmnt, lightAmntXIncr, lightAmntYIncr,
-		depthBuffer, leftHanded );
+// clips the polygon in inVertices against the plane axis * factor = w, returns the number of vertices written to outVertices
+inline unsigned int clipPolygonToPlane (Vertex* inVertices, unsigned int inVerticesSize, Vertex* outVertices, unsigned int axis, float factor)
+{
+	unsigned int outVerticesSize = 0;
 
-	if ( y1Ceil != y2Ceil ) // need to account for vert 2 being in the middle of both left and right increments
-	{
-		xLeftAccumulator  += ( (static_cast<float>(y2) - y2Ceil) * xLeftIncrTop )  + ( (static_cast<float>(y2Ceil) - y2) * xLeftIncrBottom );
-		xRightAccumulator += ( (static_cast<float>(y2) - y2Ceil) * xRightIncrTop ) + ( (static_cast<float>(y2Ceil) - y2) * xRightIncrBottom );
-	}
-	else if ( ! floatsAreEqual(y1, y2) ) // still need to account for vert 2 being in the middle of both left and right increments
+	for ( unsigned int vertNum = 0; vertNum < inVerticesSize; vertNum++ )
 	{
-		xLeftAccumulator  = x1 + ( (y2 - y1) * xLeftIncrTop )  + ( (static_cast<float>(y2Ceil) - y2) * xLeftIncrBottom );
-		xRightAccumulator = x1 + ( (y2 - y1) * xRightIncrTop ) + ( (static_cast<float>(y2Ceil) - y2) * xRightIncrBottom );
-	}
-	else
-	{
-		xLeftAccumulator = x1 + ( (static_cast<float>(y2Ceil) - y2) * xLeftIncrBottom );
-		xRightAccumulator = x2 + ( (static_cast<float>(y2Ceil) - y2) * xRightIncrBottom );
+		Vertex& currentVert = inVertices[vertNum];
+		Vertex& nextVert = inVertices[(vertNum + 1) % inVerticesSize];
+
+		const float currentVertValue = currentVert.vec.at( axis ) * factor;
+		const float nextVertValue = nextVert.vec.at( axis ) * factor;
+
+		const bool currentInside = currentVertValue <= currentVert.vec.w();
+		const bool nextInside = nextVertValue <= nextVert.vec.w();
+
+		if ( currentInside != nextInside )
+		{
+			// add intersection
+			const float lerpAmnt = ( currentVert.vec.w() - currentVertValue )
+				/ ( (currentVert.vec.w() - currentVertValue) - (nextVert.vec.w() - nextVertValue) );
+			outVertices[outVerticesSize] = currentVert.lerp( nextVert, lerpAmnt );
+			outVerticesSize++;
+		}
+
+		if ( nextInside )
+		{
+			outVertices[outVerticesSize] = nextVert;
+			outVerticesSize++;
+		}
 	}
 
-	// rasterize up until the last vertice
-	renderScanlines<texFormat, withTransparency>( y2Ceil, y3Ceil, x1, y1, xLeftAccumulator, xRightAccumulator, v1PerspMul,
-		v1Depth, xLeftIncrBottom, xRightIncrBottom, shaderData, currentColor, texCoordX1, texCoordY1, texCoordXXIncr, texCoordXYIncr,
-		texCoordYXIncr, texCoordYYIncr, perspXIncr, perspYIncr, depthXIncr, depthYIncr, v1LightAmnt, lightAmntXIncr, lightAmntYIncr,
-		depthBuffer, leftHanded );
+	return outVerticesSize;
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-template <CP_FORMAT texFormat, bool withTransparency>
-void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::drawTriangleShadedHelper (Face& face,
-			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, std::array<float, width * height>& depthBuffer)
+template <CP_FORMAT texFormat, typename ShaderProg, typename RasterizeFunc>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::transformAndClipTriangle (Face& face,
+			TriShaderData<texFormat, api, shaderPassDataSize>& shaderData, RasterizeFunc&& rasterizeFunc)
 {
 	// setup shader data
 	Camera3D& camera = shaderData.camera;
 
-	// get previous color, since we'll want to set it back when we're done with the shading colors
-	const Color previousColor = m_ColorProfile.template getColor<format>();
-
 	// put through the vertex shader first
-	( *shaderData.vShader )( shaderData );
+	ShaderProg::vShader( shaderData );
 
 	// TODO camera projection should be done in the vertex shader?
 	camera.multiplyByCameraMatrix( face );
 
-	// backface culling
-	const Vector<4>& vertexVec = face.vertices[0].vec;
-	const Vector<4>& normal = face.calcFaceNormals();
-	if ( ! (normal.x() * (vertexVec.x() - camera.x())
-			+ normal.y() * (vertexVec.y() - camera.y())
-			+ normal.z() * (vertexVec.z() - camera.z()) <= 0.0f) )
+	if constexpr ( RENDER_STATS_ENABLED )
+	{
+		m_FrameStats.trianglesSubmitted++;
+	}
+
+	if ( isBackFacing(face, camera) )
 	{
+		if constexpr ( RENDER_STATS_ENABLED )
+		{
+			m_FrameStats.trianglesBackFaceCulled++;
+		}
+
 		return;
 	}
 
@@ -923,78 +2598,79 @@ void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataS
 
 	if ( v1Inside && v2Inside && v3Inside )
 	{
+		if constexpr ( RENDER_STATS_ENABLED )
+		{
+			m_FrameStats.trianglesTriviallyAccepted++;
+		}
+
 		camera.perspectiveDivide( face );
 		camera.scaleXYToZeroToOne( face );
 
 		// triangle is entirely inside of the clip space, so draw and return
-		SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-			renderInBoundsTriangle<texFormat, withTransparency>( face, shaderData, depthBuffer );
-
-		// set the previously used color back since we're done with the gradients
-		m_ColorProfile.setColor( previousColor );
+		rasterizeFunc( face );
 
 		return;
 	}
 
-	// otherwise, clip into subtriangles
-	constexpr unsigned int maxPossibleVerts = 36; // TODO this is probably excessive
-	Vertex outVertices[maxPossibleVerts];
-	outVertices[0] = face.vertices[0];
-	outVertices[1] = face.vertices[1];
-	outVertices[2] = face.vertices[2];
-	unsigned int outVerticesSize = 3;
+	this->clipTriangle( face, camera, rasterizeFunc );
+}
 
-	const float factors[2] = { 1.0f, -1.0f };
-	for ( unsigned int factorIndex = 0; factorIndex < 2; factorIndex++ )
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+template <typename RasterizeFunc>
+void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::clipTriangle (Face& face, Camera3D& camera,
+			RasterizeFunc&& rasterizeFunc)
+{
+	if constexpr ( RENDER_STATS_ENABLED )
 	{
-		for ( unsigned int axis = 0; axis < 3; axis++ ) // clip x, y, z axis
-		{
-			Vertex newVertices[maxPossibleVerts];
-			unsigned int newVerticesSize = outVerticesSize;
-			std::copy( std::begin(outVertices), std::end(outVertices), std::begin(newVertices) );
-			outVerticesSize = 0;
+		m_FrameStats.trianglesClipped++;
+	}
 
-			for ( unsigned int vertNum = 0; vertNum < newVerticesSize; vertNum++ )
-			{
-				Vertex currentVert = newVertices[vertNum];
-				Vertex nextVert = newVertices[(vertNum + 1) % newVerticesSize];
+	// clip into subtriangles. Only the near and far planes need to be clipped against as long as the result stays
+	// inside of the guard band, since the rasterizer scissors x and y to the screen for each span
+	constexpr unsigned int maxPossibleVerts = 36; // TODO this is probably excessive
+	Vertex verticesA[maxPossibleVerts] = { face.vertices[0], face.vertices[1], face.vertices[2] };
+	Vertex verticesB[maxPossibleVerts];
+	Vertex* outVertices = verticesA;
+	Vertex* newVertices = verticesB;
+	unsigned int outVerticesSize = 3;
 
-				const float currentVertValue = currentVert.vec.at( axis ) * factors[factorIndex];
-				const float nextVertValue = nextVert.vec.at( axis ) * factors[factorIndex];
+	outVerticesSize = clipPolygonToPlane( outVertices, outVerticesSize, newVertices, 2, 1.0f );
+	outVerticesSize = clipPolygonToPlane( newVertices, outVerticesSize, outVertices, 2, -1.0f );
 
-				const bool currentInside = currentVertValue <= currentVert.vec.w();
-				const bool nextInside = nextVertValue <= nextVert.vec.w();
+	bool insideGuardBand = true;
+	for ( unsigned int vertNum = 0; vertNum < outVerticesSize; vertNum++ )
+	{
+		const Vector<4>& vec = outVertices[vertNum].vec;
+		const float guardBandW = std::abs( vec.w() ) * m_GuardBandSize;
+		if ( std::abs(vec.x()) > guardBandW || std::abs(vec.y()) > guardBandW )
+		{
+			insideGuardBand = false;
+			break;
+		}
+	}
 
-				if ( nextInside )
-				{
-					if ( ! currentInside )
-					{
-						// add intersection
-						const float lerpAmnt = ( currentVert.vec.w() - currentVertValue )
-							/ ( (currentVert.vec.w() - currentVertValue) - (nextVert.vec.w() - nextVertValue) );
-						Vertex intersect = currentVert.lerp( nextVert, lerpAmnt );
-						outVertices[outVerticesSize] = intersect;
-						outVerticesSize++;
-					}
+	if ( ! insideGuardBand )
+	{
+		m_FullClipCount++;
 
-					outVertices[outVerticesSize] = nextVert;
-					outVerticesSize++;
-				}
-				else if ( currentInside )
-				{
-					// add intersection
-					const float lerpAmnt = ( currentVert.vec.w() - currentVertValue )
-						/ ( (currentVert.vec.w() - currentVertValue) - (nextVert.vec.w() - nextVertValue) );
-					Vertex intersect = currentVert.lerp( nextVert, lerpAmnt );
-					outVertices[outVerticesSize] = intersect;
-					outVerticesSize++;
-				}
+		const float factors[2] = { 1.0f, -1.0f };
+		for ( unsigned int factorIndex = 0; factorIndex < 2; factorIndex++ )
+		{
+			for ( unsigned int axis = 0; axis < 2; axis++ ) // clip x, y axis
+			{
+				outVerticesSize = clipPolygonToPlane( outVertices, outVerticesSize, newVertices, axis, factors[factorIndex] );
+				std::swap( outVertices, newVertices );
 			}
 		}
 	}
 
 	if ( outVerticesSize > 2 )
 	{
+		if constexpr ( RENDER_STATS_ENABLED )
+		{
+			m_FrameStats.clippedSubTriangles += outVerticesSize - 2;
+		}
+
 		for ( unsigned int vertNum = 1; vertNum < outVerticesSize - 1; vertNum++ )
 		{
 			Face clippedFace{ outVertices[0], outVertices[vertNum], outVertices[vertNum + 1] };
@@ -1002,24 +2678,18 @@ void SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataS
 			camera.perspectiveDivide( clippedFace );
 			camera.scaleXYToZeroToOne( clippedFace );
 
-			// triangle is entirely inside of the clip space, so draw
-			SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-				renderInBoundsTriangle<texFormat, withTransparency>( clippedFace, shaderData, depthBuffer );
+			// triangle is entirely inside of the near and far planes and the guard band, so draw
+			rasterizeFunc( clippedFace );
 		}
 	}
-
-	// set the previously used color back since we're done with the gradients
-	m_ColorProfile.setColor( previousColor );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawQuad (float x1, float y1, float x2, float y2, float x3, float y3,
 		float x4, float y4)
 {
-	drawLine( x1, y1, x2, y2 );
-	drawLine( x2, y2, x3, y3 );
-	drawLine( x3, y3, x4, y4 );
-	drawLine( x4, y4, x1, y1 );
+	const float points[] = { x1, y1, x2, y2, x3, y3, x4, y4 };
+	this->drawPolyline( points, 4, true );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
@@ -1031,110 +2701,34 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
-void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawCircleHelper (int originX, int originY, int x, int y, bool filled)
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawCircleHelper (int originX, int originY, int x, int y)
 {
-	int x1_3 = originX + x;
-	int y1_2 = originY + y;
-	int x2_4 = originX - x;
-	int y3_4 = originY - y;
-	int x5_7 = originX + y;
-	int y5_6 = originY + x;
-	int x6_8 = originX - y;
-	int y7_8 = originY - x;
-
-	// clipping
-	if (x1_3 < 0) x1_3 = 0;
-	if (x2_4 < 0) x2_4 = 0;
-	if (x5_7 < 0) x5_7 = 0;
-	if (x6_8 < 0) x6_8 = 0;
-	if (x1_3 > (int)width) x1_3 = width;
-	if (x2_4 > (int)width) x2_4 = width;
-	if (x5_7 > (int)width) x5_7 = width;
-	if (x6_8 > (int)width) x6_8 = width;
-
-	int pixel1 = ( (y1_2 * width) + x1_3  );
-	int pixel2 = ( (y1_2 * width) + x2_4  );
-	int pixel3 = ( (y3_4 * width) + x1_3  );
-	int pixel4 = ( (y3_4 * width) + x2_4  );
-	int pixel5 = ( (y5_6 * width) + x5_7  );
-	int pixel6 = ( (y5_6 * width) + x6_8  );
-	int pixel7 = ( (y7_8 * width) + x5_7  );
-	int pixel8 = ( (y7_8 * width) + x6_8  );
-
-	if (filled)
-	{
-		// span from pixel2 to pixel1
-		int tempPixel = pixel2;
-		if (y1_2 >= 0 && y1_2 < (int)height)
-		{
-			while (tempPixel < pixel1)
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), tempPixel );
-				tempPixel += 1;
-			}
-		}
-
-		// span from pixel4 to pixel3
-		if (y3_4 >= 0 && y3_4 < (int)height)
-		{
-			tempPixel = pixel4;
-			while (tempPixel < pixel3)
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), tempPixel );
-				tempPixel += 1;
-			}
-		}
-
-		// span from pixel6 to pixel5
-		if (y5_6 >= 0 && y5_6 < (int)height)
-		{
-			tempPixel = pixel6;
-			while (tempPixel < pixel5)
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), tempPixel );
-				tempPixel += 1;
-			}
-		}
-
-		// span form pixel8 to pixel7
-		if (y7_8 >= 0 && y7_8 < (int)height)
-		{
-			tempPixel = pixel8;
-			while (tempPixel < pixel7)
-			{
-				m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), tempPixel );
-				tempPixel += 1;
-			}
-		}
-	}
-	else
+	// clipping, points outside of the clip rect are skipped instead of being moved onto its edge
+	auto putCirclePixel = [this](int pixelX, int pixelY)
 	{
-		if (y1_2 >= 0 && y1_2 < (int)height)
-		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel1 );
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel2 );
-		}
-		if (y3_4 >= 0 && y3_4 < (int)height)
-		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel3 );
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel4 );
-		}
-		if (y5_6 >= 0 && y5_6 < (int)height)
-		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel5 );
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel6 );
-		}
-		if (y7_8 >= 0 && y7_8 < (int)height)
+		if ( this->clipRectContains(pixelX, pixelY) )
 		{
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel7 );
-			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel8 );
+			const int pixel = ( pixelY * width ) + pixelX;
+			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixel );
+			this->countPixelsWritten( RENDER_PRIMITIVE::CIRCLE, pixel, 1 );
 		}
-	}
+	};
+
+	putCirclePixel( originX + x, originY + y );
+	putCirclePixel( originX - x, originY + y );
+	putCirclePixel( originX + x, originY - y );
+	putCirclePixel( originX - x, originY - y );
+	putCirclePixel( originX + y, originY + x );
+	putCirclePixel( originX - y, originY + x );
+	putCirclePixel( originX + y, originY - x );
+	putCirclePixel( originX - y, originY - x );
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawCircle (float originX, float originY, float radius)
 {
+	this->flushDeferredTriangles();
+
 	// getting the pixel values of the vertices
 	int originXUInt = originX * (width  - 1);
 	int originYUInt = originY * (height - 1);
@@ -1145,6 +2739,9 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 	int y = radiusUInt;
 	int decision = 3 - 2 * radiusUInt;
 
+	this->resolvePendingFill( originXUInt - radiusUInt, originYUInt - radiusUInt, originXUInt + radiusUInt + 1, originYUInt + radiusUInt + 1,
+					m_ColorProfile );
+
 	drawCircleHelper( originXUInt, originYUInt, x, y );
 
 	while (y >= x)
@@ -1167,44 +2764,293 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawCircleFilled (float originX, float originY, float radius)
 {
+	this->flushDeferredTriangles();
+
 	// getting the pixel values of the vertices
 	int originXUInt = originX * (width  - 1);
 	int originYUInt = originY * (height - 1);
 	int radiusUInt = radius * (width - 1);
 
-	// bresenham's algorithm
-	int x = 0;
-	int y = radiusUInt;
-	int decision = 3 - 2 * radiusUInt;
+	this->drawEllipseFilledHelper( originXUInt, originYUInt, radiusUInt, radiusUInt );
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawEllipseFilled (float originX, float originY, float radiusX,
+		float radiusY)
+{
+	this->flushDeferredTriangles();
+
+	// getting the pixel values of the vertices
+	int originXUInt = originX * (width  - 1);
+	int originYUInt = originY * (height - 1);
+	int radiusXUInt = radiusX * (width  - 1);
+	int radiusYUInt = radiusY * (height - 1);
 
-	drawCircleHelper( originXUInt, originYUInt, x, y, true );
+	this->drawEllipseFilledHelper( originXUInt, originYUInt, radiusXUInt, radiusYUInt );
+}
 
-	while (y >= x)
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawEllipseFilledHelper (int originX, int originY, int radiusX,
+		int radiusY)
+{
+	if ( radiusX < 0 || radiusY < 0 )
 	{
-		x++;
-		if (decision > 0)
+		return;
+	}
+
+	const ScissorRect& clipRect = this->m_ClipRect;
+	const int xMin = std::max( originX - radiusX, clipRect.xMin );
+	const int yMin = std::max( originY - radiusY, clipRect.yMin );
+	const int xMaxExclusive = std::min( originX + radiusX + 1, clipRect.xMaxExclusive );
+	const int yMaxExclusive = std::min( originY + radiusY + 1, clipRect.yMaxExclusive );
+	if ( xMin >= xMaxExclusive || yMin >= yMaxExclusive )
+	{
+		return;
+	}
+
+	this->resolvePendingFill( xMin, yMin, xMaxExclusive, yMaxExclusive, m_ColorProfile );
+
+	// every pixel is only written once, so translucent ellipses can be blended
+	const bool alphaBlend = m_ColorProfile.template getColor<format>().m_A < 1.0f;
+	auto drawSpan = [&](int row, int halfWidth)
+	{
+		if ( row < yMin || row >= yMaxExclusive )
 		{
-			y--;
-			decision = decision + 4 * (x - y) + 10;
+			return;
+		}
+
+		const int spanXStart = std::max( originX - halfWidth, xMin );
+		const int spanXEnd   = std::min( originX + halfWidth, xMaxExclusive - 1 );
+		if ( spanXStart > spanXEnd )
+		{
+			return;
+		}
+
+		const unsigned int pixelStart = ( row * width ) + spanXStart;
+		const unsigned int numPixels = spanXEnd - spanXStart + 1;
+		if ( alphaBlend )
+		{
+			for ( unsigned int pixel = pixelStart; pixel < pixelStart + numPixels; pixel++ )
+			{
+				m_ColorProfile.template putPixelWithAlphaBlending<width, height>( m_FB.getPixels(), pixel );
+			}
 		}
 		else
 		{
-			decision = decision + 4 * x + 6;
+			m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixelStart, numPixels );
+		}
+		this->countPixelsWritten( RENDER_PRIMITIVE::CIRCLE, pixelStart, numPixels );
+	};
+
+	// a pixel is inside if it's inside of the ellipse with half a pixel added to both radii. Everything is doubled so that the
+	// test stays in integers, and the half width of a row can only shrink going away from the middle row
+	const int64_t doubledRadiusXSquared = static_cast<int64_t>( (radiusX * 2) + 1 ) * ( (radiusX * 2) + 1 );
+	const int64_t doubledRadiusYSquared = static_cast<int64_t>( (radiusY * 2) + 1 ) * ( (radiusY * 2) + 1 );
+	const int64_t limit = doubledRadiusXSquared * doubledRadiusYSquared;
+	int halfWidth = radiusX;
+	for ( int rowOffset = 0; rowOffset <= radiusY; rowOffset++ )
+	{
+		const int64_t rowTerm = static_cast<int64_t>( rowOffset * 2 ) * ( rowOffset * 2 ) * doubledRadiusXSquared;
+		while ( halfWidth > 0 && (static_cast<int64_t>(halfWidth * 2) * (halfWidth * 2) * doubledRadiusYSquared) + rowTerm > limit )
+		{
+			halfWidth--;
 		}
 
-		drawCircleHelper( originXUInt, originYUInt, x, y, true );
+		drawSpan( originY + rowOffset, halfWidth );
+		if ( rowOffset > 0 )
+		{
+			drawSpan( originY - rowOffset, halfWidth );
+		}
 	}
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawText (float xStart, float yStart, const char* text, float scaleFactor)
 {
+	this->flushDeferredTriangles();
+
 	// TODO text doesn't render if scale factor isn't an integer beyond 1.0f, fix later?
 	if ( scaleFactor > 1.0f )
 	{
 		scaleFactor = std::round( scaleFactor );
 	}
+	else if ( scaleFactor < 1.0f )
+	{
+		this->drawTextDownscaled( xStart, yStart, text, scaleFactor );
+		return;
+	}
+
+	// glyphs are scaled up by whole pixels, so each run of set pixels in a glyph is drawn as scale spans
+	const int scale = scaleFactor;
+	const int textX = xStart * (width  - 1);
+	const int textY = yStart * (height - 1);
+	const int characterWidth = m_CurrentFont->getCharacterWidth() * scale;
+	const int characterHeight = m_CurrentFont->getBitmapHeight() * scale;
+	const ScissorRect& clipRect = this->m_ClipRect;
+	if ( textY >= clipRect.yMaxExclusive || textY + characterHeight <= clipRect.yMin )
+	{
+		return;
+	}
+
+	const int textXEnd = textX + ( static_cast<int>(std::strlen(text)) * characterWidth );
+	this->resolvePendingFill( textX, textY, textXEnd, textY + characterHeight, m_ColorProfile );
+
+	// characters only move right, so the rest of the text is outside of the clip rect once one starts past its right edge
+	int characterX = textX;
+	for ( unsigned int charIndex = 0; text[charIndex] != '\0' && characterX < clipRect.xMaxExclusive; charIndex++ )
+	{
+		if ( characterX + characterWidth > clipRect.xMin )
+		{
+			unsigned int numRuns = 0;
+			const FontGlyphRun* runs = m_CurrentFont->getGlyphRuns( text[charIndex], numRuns );
+			for ( unsigned int runNum = 0; runNum < numRuns; runNum++ )
+			{
+				const FontGlyphRun& run = runs[runNum];
+				const int spanXStart = std::max( characterX + (run.xStart * scale), clipRect.xMin );
+				const int spanXEnd = std::min( characterX + ((run.xStart + run.length) * scale), clipRect.xMaxExclusive );
+				const int rowStart = std::max( textY + (run.row * scale), clipRect.yMin );
+				const int rowEnd = std::min( textY + ((run.row + 1) * scale), clipRect.yMaxExclusive );
+				if ( spanXStart >= spanXEnd )
+				{
+					continue;
+				}
+
+				for ( int row = rowStart; row < rowEnd; row++ )
+				{
+					const unsigned int pixelStart = ( row * width ) + spanXStart;
+					m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixelStart, spanXEnd - spanXStart );
+					this->countPixelsWritten( RENDER_PRIMITIVE::TEXT, pixelStart, spanXEnd - spanXStart );
+				}
+			}
+		}
+
+		characterX += characterWidth;
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawTextCached (float xStart, float yStart, const char* text,
+		float scaleFactor)
+{
+	this->flushDeferredTriangles();
+
+	if ( scaleFactor > 1.0f )
+	{
+		scaleFactor = std::round( scaleFactor );
+	}
+	else if ( scaleFactor < 1.0f )
+	{
+		this->drawTextDownscaled( xStart, yStart, text, scaleFactor );
+		return;
+	}
+
+	// text that's entirely outside of the clip rect isn't rendered into the cache
+	const ScissorRect& clipRect = this->m_ClipRect;
+	const int textX = xStart * (width  - 1);
+	const int textY = yStart * (height - 1);
+	if ( textX >= clipRect.xMaxExclusive || textY >= clipRect.yMaxExclusive
+			|| textY + static_cast<int>(m_CurrentFont->getBitmapHeight() * scaleFactor) <= clipRect.yMin )
+	{
+		return;
+	}
+
+	const RenderedText& renderedText = m_TextCache.getText( *m_CurrentFont, text, scaleFactor );
+	if ( textX + static_cast<int>(renderedText.width) <= clipRect.xMin )
+	{
+		return;
+	}
+
+	this->resolvePendingFill( textX, textY, textX + renderedText.width, textY + renderedText.height, m_ColorProfile );
+
+	if constexpr ( format == CP_FORMAT::MONOCHROME_1BIT )
+	{
+		// a cache that was replaced with one that keeps spans is drawn from its spans below
+		if ( ! renderedText.masks.empty() )
+		{
+			this->drawTextMasks( textX, textY, renderedText );
+			return;
+		}
+	}
+
+	for ( const TextSpan& span : renderedText.spans )
+	{
+		const int row = textY + span.row;
+		if ( row < clipRect.yMin )
+		{
+			continue;
+		}
+		if ( row >= clipRect.yMaxExclusive )
+		{
+			break;
+		}
+
+		const int spanXStart = std::max( textX + span.xStart, clipRect.xMin );
+		const int spanXEnd = std::min( textX + span.xStart + span.length, clipRect.xMaxExclusive );
+		if ( spanXStart < spanXEnd )
+		{
+			const unsigned int pixelStart = ( row * width ) + spanXStart;
+			m_ColorProfile.template putSpan<width, height>( m_FB.getPixels(), pixelStart, spanXEnd - spanXStart );
+			this->countPixelsWritten( RENDER_PRIMITIVE::TEXT, pixelStart, spanXEnd - spanXStart );
+		}
+	}
+}
+
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawTextMasks (int textX, int textY,
+		const RenderedText& renderedText)
+{
+	// the mask of each row is shifted to where the row starts in the frame buffer and written a word at a time
+	const ScissorRect& clipRect = this->m_ClipRect;
+	const int rowStart = std::max( clipRect.yMin - textY, 0 );
+	const int rowEnd = std::min( static_cast<int>(renderedText.height), clipRect.yMaxExclusive - textY );
+	const int columnStart = std::max( clipRect.xMin - textX, 0 );
+	const int columnEnd = std::min( static_cast<int>(renderedText.width), clipRect.xMaxExclusive - textX );
+	if ( columnStart >= columnEnd )
+	{
+		return;
+	}
+
+	std::array<uint8_t, (width / 8) + 2> rowMasks;
+	for ( int row = rowStart; row < rowEnd; row++ )
+	{
+		const uint8_t* textMask = &renderedText.masks[row * renderedText.maskBytesPerRow];
+		const unsigned int pixelStart = ( (textY + row) * width ) + textX + columnStart;
+		const unsigned int pixelEnd = pixelStart + ( columnEnd - columnStart );
+		const unsigned int byteStart = pixelStart / 8;
+		const unsigned int numBytes = ( (pixelEnd - 1) / 8 ) - byteStart + 1;
+
+		// the bit of the text mask that lands on the first bit of each byte, which is before the text for the first byte
+		int textBit = columnStart - static_cast<int>( pixelStart % 8 );
+		for ( unsigned int byteNum = 0; byteNum < numBytes; byteNum++, textBit += 8 )
+		{
+			const int textByte = textBit >> 3;
+			const unsigned int bitOffset = textBit & 7;
+			const unsigned int high = ( textByte >= 0 ) ? textMask[textByte] : 0;
+			const unsigned int low = ( textByte + 1 < static_cast<int>(renderedText.maskBytesPerRow) ) ? textMask[textByte + 1] : 0;
+			rowMasks[byteNum] = static_cast<uint8_t>( ((high << 8) | low) >> (8 - bitOffset) );
+		}
+		rowMasks[0] &= 0xFF >> ( pixelStart % 8 );
+		rowMasks[numBytes - 1] &= 0xFF << ( 7 - ((pixelEnd - 1) % 8) );
+
+		m_ColorProfile.template putMaskedBytes<width, height>( m_FB.getPixels(), byteStart, rowMasks.data(), numBytes );
+
+		if constexpr ( RENDER_STATS_ENABLED || RENDER_HEATMAP_ENABLED )
+		{
+			for ( unsigned int pixelNum = pixelStart; pixelNum < pixelEnd; pixelNum++ )
+			{
+				if ( rowMasks[(pixelNum / 8) - byteStart] & (0x80 >> (pixelNum % 8)) )
+				{
+					this->countPixelsWritten( RENDER_PRIMITIVE::TEXT, pixelNum, 1 );
+				}
+			}
+		}
+	}
+}
 
+template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
+void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawTextDownscaled (float xStart, float yStart, const char* text,
+		float scaleFactor)
+{
 	// getting the pixel values of the vertices
 	int currentXInt = xStart * (width  - 1);
 	int currentYInt = yStart * (height - 1);
@@ -1230,6 +3076,8 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 	float nNCurrentY = 0.0f;
 	float nNYLeftOver = 0.0f;
 
+	this->resolvePendingFill( 0, currentYInt, width, currentYInt + scaledHeight + 1, m_ColorProfile );
+
 	// for left border clipping
 	unsigned int numXPixelsToSkip = 0;
 	if ( xStart < 0.0f )
@@ -1287,9 +3135,11 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 								&& pixelToWrite >= 0
 								&& pixelToWrite < static_cast<int>( width * height )
 								&& xPixelsSkipped >= numXPixelsToSkip
-								&& pixelToWrite < rightClipX )
+								&& pixelToWrite < rightClipX
+								&& this->clipRectContains(pixelToWrite % width, pixelToWrite / width) )
 						{
 							m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixelToWrite );
+							this->countPixelsWritten( RENDER_PRIMITIVE::TEXT, pixelToWrite, 1 );
 						}
 
 						rightClipX += width;
@@ -1366,11 +3216,46 @@ static inline void basicSpriteFShader (Color& colorOut, TriShaderData<texFormat,
 	colorOut = fShaderData.textures[0]->getColor( texCoordX, texCoordY );
 }
 
+template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+static inline void basicSpriteFShaderBatch (Color* colorsOut, TriShaderData<texFormat, api, shaderPassDataSize>& fShaderData,
+		const float* texCoordsX, const float* texCoordsY, const float* /*lightAmnts*/, unsigned int mask)
+{
+	const Texture<texFormat, api>& texture = *fShaderData.textures[0];
+	for ( unsigned int lane = 0; lane < FRAGMENT_BATCH_SIZE; lane++ )
+	{
+		if ( mask & (1u << lane) )
+		{
+			colorsOut[lane] = texture.getColor( texCoordsX[lane], texCoordsY[lane] );
+		}
+	}
+}
+
+struct BasicSpriteShaderProgram : public ShaderProgram
+{
+	static constexpr bool batchFShader = true;
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void fShader (Color& colorOut, TriShaderData<texFormat, api, shaderPassDataSize>& fShaderData, float v1Cur,
+			float v2Cur, float v3Cur, float texCoordX, float texCoordY, float lightAmnt)
+	{
+		basicSpriteFShader( colorOut, fShaderData, v1Cur, v2Cur, v3Cur, texCoordX, texCoordY, lightAmnt );
+	}
+
+	template <CP_FORMAT texFormat, RENDER_API api, unsigned int shaderPassDataSize>
+	static inline void fShaderBatch (Color* colorsOut, TriShaderData<texFormat, api, shaderPassDataSize>& fShaderData,
+			const float* texCoordsX, const float* texCoordsY, const float* lightAmnts, unsigned int mask)
+	{
+		basicSpriteFShaderBatch( colorsOut, fShaderData, texCoordsX, texCoordsY, lightAmnts, mask );
+	}
+};
+
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 template <CP_FORMAT texFormat>
 void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>::drawSpriteHelper (float xStart, float yStart,
 		Sprite<texFormat, api>& sprite)
 {
+	this->flushDeferredTriangles();
+
 	const float spriteWidthF  = static_cast<float>( sprite.getWidth() );
 	const float spriteHeightF = static_cast<float>( sprite.getHeight() );
 	const float spriteRotPointXF = sprite.getRotationPointX();
@@ -1408,7 +3293,8 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 		Color(),
 		nullptr,
 		basicSpriteVShader,
-		basicSpriteFShader
+		basicSpriteFShader,
+		basicSpriteFShaderBatch
 	};
 
 	topFace = mesh.transformedFace( 0 );
@@ -1417,39 +3303,52 @@ void SoftwareGraphics<width, height, format, api, include3D, shaderPassDataSize>
 	if constexpr ( include3D )
 	{
 		SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-			drawTriangleShadedHelper<texFormat, true>( topFace, shaderData,
+			drawTriangleShadedHelper<texFormat, true, BasicSpriteShaderProgram>( topFace, shaderData,
 					SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::m_DepthBuffer );
 
 		SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-			drawTriangleShadedHelper<texFormat, true>( bottomFace, shaderData,
+			drawTriangleShadedHelper<texFormat, true, BasicSpriteShaderProgram>( bottomFace, shaderData,
 					SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::m_DepthBuffer );
 	}
 	else
 	{
 		SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-			drawTriangleShadedHelper<texFormat, true>( topFace, shaderData, *(std::array<float, width * height>*)(nullptr) );
+			drawTriangleShadedHelper<texFormat, true, BasicSpriteShaderProgram>( topFace, shaderData, *(DepthBuffer<width, height>*)(nullptr) );
 
 		SoftwareGraphicsBase<width, height, format, api, include3D, shaderPassDataSize>::template
-			drawTriangleShadedHelper<texFormat, true>( bottomFace, shaderData, *(std::array<float, width * height>*)(nullptr) );
+			drawTriangleShadedHelper<texFormat, true, BasicSpriteShaderProgram>( bottomFace, shaderData, *(DepthBuffer<width, height>*)(nullptr) );
 	}
 }
 
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::drawDepthBuffer (Camera3D& camera)
 {
+	// any binned triangles need to be in the depth buffer first
+	this->flushTiles();
+
+	// every pixel in the clip rect is overwritten
+	const ScissorRect& clipRect = this->m_ClipRect;
+	this->discardPendingFill( clipRect.xMin, clipRect.yMin, clipRect.xMaxExclusive, clipRect.yMaxExclusive );
+
 	// get previous color, since we'll want to set it back when we're done with the shading colors
 	const Color previousColor = m_ColorProfile.template getColor<format>();
 
 	Color color;
 	const float mul = 1.0f / ( camera.getFarClip() - camera.getNearClip() );
-	for ( unsigned int pixelNum = 0; pixelNum < width * height; pixelNum++ )
+	for ( int row = clipRect.yMin; row < clipRect.yMaxExclusive; row++ )
 	{
-		float depthVal = 1.0f - ( m_DepthBuffer[pixelNum] * mul );
-		color.m_R = depthVal;
-		color.m_G = depthVal;
-		color.m_B = depthVal;
-		m_ColorProfile.setColor( color );
-		m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixelNum );
+		const unsigned int rowStart = ( row * width ) + clipRect.xMin;
+		const unsigned int rowEnd = ( row * width ) + clipRect.xMaxExclusive;
+		for ( unsigned int pixelNum = rowStart; pixelNum < rowEnd; pixelNum++ )
+		{
+			float depthVal = 1.0f - ( m_DepthBuffer.getDepth(pixelNum) * mul );
+			color.m_R = depthVal;
+			color.m_G = depthVal;
+			color.m_B = depthVal;
+			m_ColorProfile.setColor( color );
+			m_ColorProfile.template putPixel<width, height>( m_FB.getPixels(), pixelNum );
+		}
+		this->countPixelsWritten( RENDER_PRIMITIVE::DEPTH_BUFFER, rowStart, rowEnd - rowStart );
 	}
 
 	// set the previously used color back since we're done with the gradients
@@ -1459,7 +3358,10 @@ void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSiz
 template <unsigned int width, unsigned int height, CP_FORMAT format, RENDER_API api, bool include3D, unsigned int shaderPassDataSize>
 void SoftwareGraphics3D<width, height, format, api, include3D, shaderPassDataSize>::clearDepthBuffer()
 {
-	std::fill( std::begin(m_DepthBuffer), std::end(m_DepthBuffer), std::numeric_limits<float>::max() );
+	// binned triangles are depth tested against the depth buffer they were drawn with
+	this->flushTiles();
+
+	m_DepthBuffer.clear( std::numeric_limits<float>::max() );
 }
 
 
@@ -13,7 +13,11 @@
 #include "ColorProfile.hpp"
 #include "FrameBuffer.hpp"
 #include "Graphics.hpp"
+#include "FrameTiming.hpp"
+#include "DamageList.hpp"
+#include <array>
 #include <thread>
+#include <mutex>
 
 template <RENDER_API api, unsigned int width, unsigned int height, CP_FORMAT format, bool include3D, unsigned int shaderPassDataSize>
 class SurfaceBase
@@ -47,8 +51,91 @@ class SurfaceBase
 		unsigned int getWidth() { return width; }
 		unsigned int getHeight() { return height; }
 
+		// the timings of the last FRAME_TIMING_SAMPLES frames, this can be called while frames are rendering
+		FrameTimings getFrameTimings()
+		{
+			std::lock_guard<std::mutex> lock( m_FrameTimingsMutex );
+			return m_FrameTimings;
+		}
+
+		// the areas of the frame buffer last returned by advanceFrameBuffer that can differ from the frame buffer returned before
+		// it, so a display that keeps the last frame it was sent only needs to be sent these areas. A buffer still holds what was
+		// drawn to it the last time around, so this covers everything drawn to each buffer during the last frames drawn to it
+		// before it was returned, including buffers returned again without being drawn to. Draw code that only redraws what
+		// changed has to redraw what changed since the last frame drawn to the same buffer. This is the whole screen until every
+		// buffer has been drawn to and returned once, and always with RENDER_API::OPENGL
+		const DamageList& getDamage() const { return m_Damage; }
+
 	protected:
 		Graphics<width, height, format, api, include3D, shaderPassDataSize>* m_Graphics;
+
+		DamageList 	m_Damage;
+
+		// the damage of the frames last drawn to a buffer before it was returned, which starts as the whole screen
+		struct BufferDamage
+		{
+			DamageList 	damage;
+			unsigned int 	numStaleReturns; // m_NumStaleReturns when the buffer was last returned
+		};
+
+		// the number of buffers returned again without being drawn to, which sends the display back to an older frame
+		unsigned int 	m_NumStaleReturns = 0;
+
+		template <std::size_t numBuffers>
+		void initBufferDamage (std::array<BufferDamage, numBuffers>& bufferDamage)
+		{
+			for ( BufferDamage& damage : bufferDamage )
+			{
+				damage.damage.addRect( DamageRect{0, 0, width, height} );
+				damage.numStaleReturns = 0;
+			}
+			m_Damage = bufferDamage[0].damage;
+		}
+
+		// called with the buffer that's about to be returned by advanceFrameBuffer, once it's done rendering
+		template <std::size_t numBuffers>
+		void updateDamage (std::array<BufferDamage, numBuffers>& bufferDamage, unsigned int bufferNum,
+					Graphics<width, height, format, api, include3D, shaderPassDataSize>* graphics)
+		{
+			if constexpr ( api == RENDER_API::SOFTWARE )
+			{
+				BufferDamage& returned = bufferDamage[bufferNum];
+				if ( graphics->getNumDamageFrames() == 0 )
+				{
+					// a buffer returned again without being drawn to keeps its damage, since it now differs from the frame returned
+					// before it by what was drawn to either of them the last time around
+					m_NumStaleReturns++;
+				}
+				else
+				{
+					// if the display went back to an older frame since this buffer was last returned, what was drawn to it before
+					// then can differ from the frame returned before it again, so its damage is only added to
+					if ( returned.numStaleReturns == m_NumStaleReturns )
+					{
+						returned.damage.clear();
+					}
+					returned.damage.addList( graphics->getDamage() );
+					graphics->clearDamage();
+				}
+				returned.numStaleReturns = m_NumStaleReturns;
+			}
+
+			m_Damage.clear();
+			for ( const BufferDamage& damage : bufferDamage )
+			{
+				m_Damage.addList( damage.damage );
+			}
+		}
+
+		// render threads add their timings as well, so the timings are only accessed with the mutex locked
+		FrameTimings 	m_FrameTimings;
+		std::mutex 	m_FrameTimingsMutex;
+
+		void addFrameTiming (TimingHistogram<FRAME_TIMING_SAMPLES> FrameTimings::* histogram, FrameTimingClock::duration duration)
+		{
+			std::lock_guard<std::mutex> lock( m_FrameTimingsMutex );
+			( m_FrameTimings.*histogram ).addSample( duration );
+		}
 };
 
 template <RENDER_API api, unsigned int width, unsigned int height, CP_FORMAT format, unsigned int numRenderThreads, bool include3D,
@@ -61,16 +148,22 @@ class SurfaceThreaded : public SurfaceBase<api, width, height, format, include3D
 			m_GraphicsBufferReadIncr( 0 ),
 			m_GraphicsBufferWriteIncr( numRenderThreads - 1 ),
 			m_GraphicsThreadsDone{ true },
-			m_GraphicsRead( nullptr )
+			m_GraphicsRead( nullptr ),
+			m_FrameStartTimes(),
+			m_FrameLatencyPending{ false },
+			m_ThreadLaunchTimes(),
+			m_BufferDamage()
 		{
 			m_Graphics = m_GraphicsBuffer[numRenderThreads - 1];
 			for ( unsigned int bufferNum = 0; bufferNum < numRenderThreads; bufferNum++ )
 			{
 				m_GraphicsBuffer[bufferNum] = new Graphics<width, height, format, api, include3D, shaderPassDataSize>();
 				m_GraphicsThreadsDone[bufferNum] = true;
+				m_FrameLatencyPending[bufferNum] = false;
 			}
 
 			m_GraphicsRead = m_GraphicsBuffer[0];
+			this->initBufferDamage( m_BufferDamage );
 		}
 
 		~SurfaceThreaded()
@@ -112,6 +205,9 @@ class SurfaceThreaded : public SurfaceBase<api, width, height, format, include3D
 
 			advanceGraphicsWritePointer();
 
+			m_FrameStartTimes[m_GraphicsBufferWriteIncr] = FrameTimingClock::now();
+			m_FrameLatencyPending[m_GraphicsBufferWriteIncr] = true;
+
 			// ensure the next frame in the buffer is drawn
 			if ( m_GraphicsThreads[m_GraphicsBufferWriteIncr].joinable() )
 			{
@@ -120,6 +216,7 @@ class SurfaceThreaded : public SurfaceBase<api, width, height, format, include3D
 
 			// launch a new thread to render the frame
 			m_GraphicsThreadsDone[m_GraphicsBufferWriteIncr] = false;
+			m_ThreadLaunchTimes[m_GraphicsBufferWriteIncr] = FrameTimingClock::now();
 			m_GraphicsThreads[m_GraphicsBufferWriteIncr] = std::thread( &SurfaceThreaded::drawWrapper, this, m_Graphics,
 											m_GraphicsBufferWriteIncr );
 
@@ -136,8 +233,18 @@ class SurfaceThreaded : public SurfaceBase<api, width, height, format, include3D
 		using 		SurfaceBase<api, width, height, format, include3D, shaderPassDataSize>::m_Graphics;
 		Graphics<width, height, format, api, include3D, shaderPassDataSize>* 	m_GraphicsRead;
 
+		// only written by the thread calling render and advanceFrameBuffer, a render thread only reads its own launch time
+		std::array<FrameTimingClock::time_point, numRenderThreads> 	m_FrameStartTimes;
+		std::array<bool, numRenderThreads> 				m_FrameLatencyPending;
+		std::array<FrameTimingClock::time_point, numRenderThreads> 	m_ThreadLaunchTimes;
+
+		std::array<typename SurfaceThreaded::BufferDamage, numRenderThreads> 	m_BufferDamage;
+
 		void drawWrapper(Graphics<width, height, format, api, include3D, shaderPassDataSize>* graphics, unsigned int bufferNum)
 		{
+			const FrameTimingClock::time_point drawStart = FrameTimingClock::now();
+			this->addFrameTiming( &FrameTimings::threadLaunchTime, drawStart - m_ThreadLaunchTimes[bufferNum] );
+
 			if constexpr ( include3D )
 			{
 				graphics->clearDepthBuffer();
@@ -145,6 +252,8 @@ class SurfaceThreaded : public SurfaceBase<api, width, height, format, include3D
 			graphics->startFrame();
 			this->draw( graphics );
 			graphics->endFrame();
+
+			this->addFrameTiming( &FrameTimings::drawTime, FrameTimingClock::now() - drawStart );
 			m_GraphicsThreadsDone[bufferNum] = true;
 		}
 
@@ -152,10 +261,21 @@ class SurfaceThreaded : public SurfaceBase<api, width, height, format, include3D
 		{
 			// only advance if the frame is done rendering
 			unsigned int tempGraphicsBufferReadIncr = ( m_GraphicsBufferReadIncr + 1 ) % numRenderThreads;
+			const FrameTimingClock::time_point waitStart = FrameTimingClock::now();
 			while ( ! m_GraphicsThreadsDone[tempGraphicsBufferReadIncr] ) {}
+			const FrameTimingClock::time_point waitEnd = FrameTimingClock::now();
+			this->addFrameTiming( &FrameTimings::readWaitTime, waitEnd - waitStart );
 
 			m_GraphicsBufferReadIncr = tempGraphicsBufferReadIncr;
 			m_GraphicsRead = m_GraphicsBuffer[m_GraphicsBufferReadIncr];
+			this->updateDamage( m_BufferDamage, m_GraphicsBufferReadIncr, m_GraphicsRead );
+
+			// buffers that haven't been rendered to yet have no latency
+			if ( m_FrameLatencyPending[m_GraphicsBufferReadIncr] )
+			{
+				this->addFrameTiming( &FrameTimings::frameLatency, waitEnd - m_FrameStartTimes[m_GraphicsBufferReadIncr] );
+				m_FrameLatencyPending[m_GraphicsBufferReadIncr] = false;
+			}
 		}
 
 		void advanceGraphicsWritePointer()
@@ -177,9 +297,12 @@ class SurfaceSingleCore : public SurfaceBase<api, width, height, format, include
 #ifndef NO_GPU
 			m_GraphicsBuffer[0] = new Graphics<width, height, format, api, include3D, shaderPassDataSize>();
 			m_GraphicsBuffer[1] = new Graphics<width, height, format, api, include3D, shaderPassDataSize>();
+#else
+			m_GraphicsBuffer.fill( nullptr );
 #endif
 
 			m_Graphics = m_GraphicsBuffer[1];
+			this->initBufferDamage( m_BufferDamage );
 		}
 
 		~SurfaceSingleCore()
@@ -188,6 +311,8 @@ class SurfaceSingleCore : public SurfaceBase<api, width, height, format, include
 #ifndef NO_GPU
 			delete m_GraphicsBuffer[0];
 			delete m_GraphicsBuffer[1];
+#else
+			this->destroyGraphicsObjectsInMemory();
 #endif
 		}
 
@@ -197,6 +322,7 @@ class SurfaceSingleCore : public SurfaceBase<api, width, height, format, include
 		{
 			if ( memorySize > sizeof(Graphics<width, height, format, api, include3D, shaderPassDataSize>) * 2 )
 			{
+				this->destroyGraphicsObjectsInMemory();
 				m_GraphicsBuffer[0] = new (memoryLocation) Graphics<width, height, format, api, include3D, shaderPassDataSize>();
 				m_GraphicsBuffer[1] = new (memoryLocation + sizeof(Graphics<width, height, format, api, include3D, shaderPassDataSize>))
 							Graphics<width, height, format, api, include3D, shaderPassDataSize>();
@@ -212,8 +338,16 @@ class SurfaceSingleCore : public SurfaceBase<api, width, height, format, include
 
 		FrameBufferFixed<width, height, format, api>& advanceFrameBuffer()
 		{
+			if ( m_FrameLatencyPending )
+			{
+				this->addFrameTiming( &FrameTimings::frameLatency, FrameTimingClock::now() - m_FrameStartTime );
+				m_FrameLatencyPending = false;
+			}
+
 			m_Graphics = m_GraphicsBuffer[static_cast<unsigned int>(m_DrawingBuffer1)];
 			m_DrawingBuffer1 = !m_DrawingBuffer1;
+			this->updateDamage( m_BufferDamage, static_cast<unsigned int>(m_DrawingBuffer1),
+						m_GraphicsBuffer[static_cast<unsigned int>(m_DrawingBuffer1)] );
 
 			FrameBufferFixed<width, height, format, api>& fb = m_GraphicsBuffer[static_cast<unsigned int>(m_DrawingBuffer1)]->getFrameBuffer();
 			return fb;
@@ -227,6 +361,9 @@ class SurfaceSingleCore : public SurfaceBase<api, width, height, format, include
 
 		bool render()
 		{
+			m_FrameStartTime = FrameTimingClock::now();
+			m_FrameLatencyPending = true;
+
 			if constexpr ( include3D )
 			{
 				m_Graphics->clearDepthBuffer();
@@ -234,12 +371,32 @@ class SurfaceSingleCore : public SurfaceBase<api, width, height, format, include
 			m_Graphics->startFrame();
 			this->draw( m_Graphics );
 			m_Graphics->endFrame();
+
+			this->addFrameTiming( &FrameTimings::drawTime, FrameTimingClock::now() - m_FrameStartTime );
 			return false;
 		}
 
 	private:
 		bool m_DrawingBuffer1 = true;
+		FrameTimingClock::time_point 	m_FrameStartTime;
+		bool 				m_FrameLatencyPending = false;
 		std::array<Graphics<width, height, format, api, include3D, shaderPassDataSize>*, 2> 	m_GraphicsBuffer;
+		std::array<typename SurfaceSingleCore::BufferDamage, 2> 			m_BufferDamage;
+
+#ifdef NO_GPU
+		// the memory belongs to the user, but the graphics objects are still destroyed, since they can own worker threads
+		void destroyGraphicsObjectsInMemory()
+		{
+			for ( Graphics<width, height, format, api, include3D, shaderPassDataSize>*& graphics : m_GraphicsBuffer )
+			{
+				if ( graphics )
+				{
+					graphics->~Graphics();
+					graphics = nullptr;
+				}
+			}
+		}
+#endif
 
 		using 		SurfaceBase<api, width, height, format, include3D, shaderPassDataSize>::m_Graphics;
 };
@@ -0,0 +1,92 @@
+#ifndef TEXTCACHE_HPP
+#define TEXTCACHE_HPP
+
+/**************************************************************************
+ * The TextCache class holds strings that were already rendered with a
+ * font at a scale, so that static text like labels and units doesn't
+ * have to be rendered from the glyphs of the font every frame. A string
+ * is rendered once into the spans of set pixels of each row, with the
+ * spans of neighboring characters joined, so drawing it again is one
+ * span fill per span. For monochrome frame buffers, whose spans are
+ * often only a few bits of a byte, it's rendered into a mask of bits
+ * for each row instead, so drawing it is one masked write per row. The
+ * strings that were used least recently are evicted when the cache
+ * grows past its size in bytes.
+ *
+ * Fonts are only pointed to, so the cache has to be cleared before a
+ * font it has seen is destroyed.
+**************************************************************************/
+
+#include "Font.hpp"
+
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef TEXT_CACHE_SIZE_IN_BYTES
+constexpr unsigned int TEXT_CACHE_MAX_BYTES = TEXT_CACHE_SIZE_IN_BYTES;
+#else
+constexpr unsigned int TEXT_CACHE_MAX_BYTES = 16384;
+#endif
+
+// a span of set pixels in a rendered string, in pixels from the top left of the string
+struct TextSpan
+{
+	uint16_t row;
+	uint16_t xStart;
+	uint16_t length;
+};
+
+// strings are cut off after 65535 pixels. A string is kept either as spans or, for monochrome frame buffers, as masks
+struct RenderedText
+{
+	std::vector<TextSpan> 	spans; // from top to bottom and left to right
+	std::vector<uint8_t> 	masks; // maskBytesPerRow bytes for each row, with the pixels from the most significant bit down
+	unsigned int 		maskBytesPerRow;
+	unsigned int 		width;
+	unsigned int 		height;
+};
+
+class TextCache
+{
+	public:
+		// with keepMasks, strings are kept as a bit for each pixel instead of as spans, which a monochrome frame buffer can take
+		// a byte at a time
+		TextCache (unsigned int maxBytes = TEXT_CACHE_MAX_BYTES, bool keepMasks = false);
+
+		// renders the text if it isn't cached already. The rendered text is only valid until the next call, since text that's too
+		// big for the cache isn't kept
+		const RenderedText& getText (const Font& font, const char* text, unsigned int scaleFactor);
+		void clear();
+
+		unsigned int getSizeInBytes() const { return m_SizeInBytes; }
+		unsigned int getNumEntries() const { return m_Entries.size(); }
+
+	private:
+		struct TextCacheEntry
+		{
+			const Font* 	font;
+			std::string 	text;
+			unsigned int 	scaleFactor;
+			std::size_t 	hash;
+			RenderedText 	renderedText;
+			unsigned int 	sizeInBytes;
+		};
+
+		unsigned int 				m_MaxBytes;
+		bool 					m_KeepMasks;
+		unsigned int 				m_SizeInBytes;
+		std::list<TextCacheEntry> 		m_Entries; // the most recently used first
+		std::unordered_multimap<std::size_t, std::list<TextCacheEntry>::iterator> m_EntriesByHash;
+		RenderedText 				m_UncachedText;
+
+		static std::size_t getHash (const Font& font, const char* text, unsigned int scaleFactor);
+		static unsigned int getSizeInBytes (const TextCacheEntry& entry);
+		static void renderText (const Font& font, const char* text, unsigned int scaleFactor, bool keepMasks,
+					RenderedText& renderedTextOut);
+		void evictLeastRecentlyUsed();
+};
+
+#endif // TEXTCACHE_HPP
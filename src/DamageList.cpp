@@ -0,0 +1,102 @@
+#include "DamageList.hpp"
+
+#include <algorithm>
+
+DamageList::DamageList() :
+	m_Rects(),
+	m_NumRects( 0 )
+{
+}
+
+void DamageList::addRect (const DamageRect& rect)
+{
+	if ( rect.xMin >= rect.xMaxExclusive || rect.yMin >= rect.yMaxExclusive )
+	{
+		return;
+	}
+
+	DamageRect newRect = rect;
+	while ( true )
+	{
+		// rects are merged if they overlap, so that no pixel is sent twice, or if merging them doesn't add any pixels
+		bool merged = false;
+		for ( unsigned int rectNum = 0; rectNum < m_NumRects; rectNum++ )
+		{
+			const DamageRect mergedRect = getUnion( newRect, m_Rects[rectNum] );
+			if ( overlaps(newRect, m_Rects[rectNum]) || mergedRect.getArea() <= newRect.getArea() + m_Rects[rectNum].getArea() )
+			{
+				newRect = mergedRect;
+				this->removeRect( rectNum );
+				merged = true;
+				break;
+			}
+		}
+
+		if ( merged )
+		{
+			// the merged rect can reach other rects now
+			continue;
+		}
+
+		if ( m_NumRects < DAMAGE_LIST_MAX_RECTS )
+		{
+			m_Rects[m_NumRects] = newRect;
+			m_NumRects++;
+			return;
+		}
+
+		// the list is full, so the new rect is merged with the rect that adds the fewest pixels
+		unsigned int bestRectNum = 0;
+		unsigned int bestGrowth = 0;
+		for ( unsigned int rectNum = 0; rectNum < m_NumRects; rectNum++ )
+		{
+			const unsigned int growth = getUnion( newRect, m_Rects[rectNum] ).getArea() - m_Rects[rectNum].getArea();
+			if ( rectNum == 0 || growth < bestGrowth )
+			{
+				bestRectNum = rectNum;
+				bestGrowth = growth;
+			}
+		}
+
+		newRect = getUnion( newRect, m_Rects[bestRectNum] );
+		this->removeRect( bestRectNum );
+	}
+}
+
+void DamageList::addList (const DamageList& list)
+{
+	for ( const DamageRect& rect : list )
+	{
+		this->addRect( rect );
+	}
+}
+
+unsigned int DamageList::getArea() const
+{
+	unsigned int area = 0;
+	for ( const DamageRect& rect : *this )
+	{
+		area += rect.getArea();
+	}
+
+	return area;
+}
+
+DamageRect DamageList::getUnion (const DamageRect& rect1, const DamageRect& rect2)
+{
+	return DamageRect{ std::min(rect1.xMin, rect2.xMin), std::min(rect1.yMin, rect2.yMin),
+				std::max(rect1.xMaxExclusive, rect2.xMaxExclusive), std::max(rect1.yMaxExclusive, rect2.yMaxExclusive) };
+}
+
+bool DamageList::overlaps (const DamageRect& rect1, const DamageRect& rect2)
+{
+	return rect1.xMin < rect2.xMaxExclusive && rect2.xMin < rect1.xMaxExclusive
+		&& rect1.yMin < rect2.yMaxExclusive && rect2.yMin < rect1.yMaxExclusive;
+}
+
+void DamageList::removeRect (unsigned int rectNum)
+{
+	// the order of the rects doesn't matter, so the last rect takes the place of the removed one
+	m_Rects[rectNum] = m_Rects[m_NumRects - 1];
+	m_NumRects--;
+}
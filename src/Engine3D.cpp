@@ -88,6 +88,52 @@ Face Mesh::transformedFace (unsigned int index)
 	return transformedFace;
 }
 
+void IndexedMesh::scale (float scaleFactor)
+{
+	transformMat.at( 0, 0 ) *= scaleFactor;
+	transformMat.at( 1, 1 ) *= scaleFactor;
+	transformMat.at( 2, 2 ) *= scaleFactor;
+}
+
+void IndexedMesh::translate (float x, float y, float z)
+{
+	transformMat.at( 3, 0 ) += x;
+	transformMat.at( 3, 1 ) += y;
+	transformMat.at( 3, 2 ) += z;
+}
+
+void IndexedMesh::rotate (float x, float y, float z)
+{
+	Matrix<4, 4> rotMatrix = generateRotationMatrix( x, y , z );
+	transformMat *= rotMatrix;
+}
+
+void IndexedMesh::applyTransformations()
+{
+	for ( unsigned int index = 0; index < vertices.size(); index++ )
+	{
+		vertices[index] = transformedVertex( index );
+	}
+
+	transformMat = generateIdentityMatrix();
+}
+
+Vertex IndexedMesh::transformedVertex (unsigned int index) const
+{
+	Vertex transformedVertex = vertices[index];
+	transformedVertex.vec = transformedVertex.vec * transformMat;
+	transformedVertex.normal = transformedVertex.normal * transformMat;
+
+	return transformedVertex;
+}
+
+Face IndexedMesh::transformedFace (unsigned int faceIndex) const
+{
+	return Face{{ transformedVertex( indices[(faceIndex * 3) + 0] ),
+			transformedVertex( indices[(faceIndex * 3) + 1] ),
+			transformedVertex( indices[(faceIndex * 3) + 2] ) }};
+}
+
 Vector<4> Face::calcFaceNormals()
 {
 	Vertex& vert1 = vertices[0];
@@ -246,6 +292,11 @@ void Camera3D::multiplyByCameraMatrix (Face& face)
 	face.vertices[2].vec = multiplyByCameraMatrix( face.vertices[2].vec );
 }
 
+void Camera3D::multiplyByCameraMatrix (Vertex& vertex)
+{
+	vertex.vec = multiplyByCameraMatrix( vertex.vec );
+}
+
 void Camera3D::perspectiveDivide (Face& face)
 {
 	face.vertices[0].vec = perspectiveDivide( face.vertices[0].vec );
@@ -253,9 +304,20 @@ void Camera3D::perspectiveDivide (Face& face)
 	face.vertices[2].vec = perspectiveDivide( face.vertices[2].vec );
 }
 
+void Camera3D::perspectiveDivide (Vertex& vertex)
+{
+	vertex.vec = perspectiveDivide( vertex.vec );
+}
+
 void Camera3D::scaleXYToZeroToOne (Face& face) const
 {
 	face.vertices[0].vec.x() = ( face.vertices[0].vec.x() + 1.0f ) * 0.5f; face.vertices[0].vec.y() = ( face.vertices[0].vec.y() + 1.0f ) * 0.5f;
 	face.vertices[1].vec.x() = ( face.vertices[1].vec.x() + 1.0f ) * 0.5f; face.vertices[1].vec.y() = ( face.vertices[1].vec.y() + 1.0f ) * 0.5f;
 	face.vertices[2].vec.x() = ( face.vertices[2].vec.x() + 1.0f ) * 0.5f; face.vertices[2].vec.y() = ( face.vertices[2].vec.y() + 1.0f ) * 0.5f;
 }
+
+void Camera3D::scaleXYToZeroToOne (Vertex& vertex) const
+{
+	vertex.vec.x() = ( vertex.vec.x() + 1.0f ) * 0.5f;
+	vertex.vec.y() = ( vertex.vec.y() + 1.0f ) * 0.5f;
+}
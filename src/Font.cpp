@@ -1,5 +1,8 @@
 #include "Font.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 static const unsigned int CHAR_WIDTH_INDEX = 0;
 static const unsigned int WIDTH_INDEX_1 = 1;
 static const unsigned int WIDTH_INDEX_2 = 2;
@@ -16,9 +19,12 @@ Font::Font (uint8_t* data) :
 	m_Height( data[HEIGHT_INDEX] ),
 	m_BitmapStartIndex( data[BITMAP_START_INDEX_INDEX] ),
 	m_BitmapStart( &data[m_BitmapStartIndex] ),
-	m_CharMap()
+	m_CharMap(),
+	m_GlyphRuns(),
+	m_GlyphRunStarts()
 {
 	this->createCharacterMap();
+	this->createGlyphRuns();
 }
 
 unsigned int Font::getCharacterWidth() const
@@ -38,16 +44,77 @@ unsigned int Font::getBitmapHeight() const
 
 unsigned int Font::getCharacterIndex (const char character) const
 {
-	return m_CharMap.at( character );
+	if ( ! this->hasCharacter(character) )
+	{
+		throw std::out_of_range( "the font doesn't have the character" );
+	}
+
+	return m_CharMap[static_cast<uint8_t>( character )];
+}
+
+bool Font::hasCharacter (const char character) const
+{
+	return m_CharMap[static_cast<uint8_t>( character )] >= 0;
+}
+
+const FontGlyphRun* Font::getGlyphRuns (const char character, unsigned int& numRunsOut) const
+{
+	const int glyph = m_CharMap[static_cast<uint8_t>( character )];
+	if ( glyph < 0 )
+	{
+		numRunsOut = 0;
+		return nullptr;
+	}
+
+	numRunsOut = m_GlyphRunStarts[glyph + 1] - m_GlyphRunStarts[glyph];
+	return m_GlyphRuns.data() + m_GlyphRunStarts[glyph];
 }
 
 void Font::createCharacterMap()
 {
+	m_CharMap.fill( -1 );
+
+	// like the map this replaced, the first mapping of a character is the one that's used
 	unsigned int currentMappingIndex;
 	for ( currentMappingIndex = MAPPING_START_INDEX; currentMappingIndex < m_BitmapStartIndex; currentMappingIndex += 2 )
 	{
-		m_CharMap.emplace( m_Data[currentMappingIndex], m_Data[currentMappingIndex + 1] );
+		if ( m_CharMap[m_Data[currentMappingIndex]] < 0 )
+		{
+			m_CharMap[m_Data[currentMappingIndex]] = m_Data[currentMappingIndex + 1];
+		}
+	}
+}
+
+void Font::createGlyphRuns()
+{
+	const int numGlyphs = *std::max_element( m_CharMap.begin(), m_CharMap.end() ) + 1;
+	m_GlyphRunStarts.assign( numGlyphs + 1, 0 );
+
+	// rows of the bitmap hold every glyph side by side, with the leftmost pixel in the highest bit
+	for ( int glyph = 0; glyph < numGlyphs; glyph++ )
+	{
+		m_GlyphRunStarts[glyph] = m_GlyphRuns.size();
+		for ( unsigned int row = 0; row < m_Height; row++ )
+		{
+			const unsigned int rowPixelIndex = ( row * m_Width ) + ( glyph * m_CharacterWidth );
+			unsigned int runLength = 0;
+			for ( unsigned int pixel = 0; pixel <= m_CharacterWidth; pixel++ )
+			{
+				const unsigned int pixelIndex = rowPixelIndex + pixel;
+				if ( pixel < m_CharacterWidth && (m_BitmapStart[pixelIndex / 8] & (1 << (7 - (pixelIndex % 8)))) )
+				{
+					runLength++;
+				}
+				else if ( runLength > 0 )
+				{
+					m_GlyphRuns.push_back( FontGlyphRun{static_cast<uint8_t>(row), static_cast<uint8_t>(pixel - runLength),
+								static_cast<uint8_t>(runLength)} );
+					runLength = 0;
+				}
+			}
+		}
 	}
+	m_GlyphRunStarts[numGlyphs] = m_GlyphRuns.size();
 }
 
 const uint8_t* Font::getBitmapStart() const
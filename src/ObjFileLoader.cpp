@@ -1,6 +1,8 @@
 #include "ObjFileLoader.hpp"
 
 #include <fstream>
+#include <map>
+#include <array>
 
 size_t splitStrBySpaces (const std::string& string, std::vector<std::string>& strings, char delimiter);
 
@@ -12,7 +14,7 @@ ObjFileLoader::~ObjFileLoader()
 {
 }
 
-bool ObjFileLoader::createMeshFromFile (Mesh& meshOut, const std::string& filePath)
+bool ObjFileLoader::loadBuffersFromFile (const std::string& filePath)
 {
 	// clear previous buffers
 	m_VertexBuffer.clear();
@@ -75,6 +77,13 @@ bool ObjFileLoader::createMeshFromFile (Mesh& meshOut, const std::string& filePa
 		}
 	}
 
+	return true;
+}
+
+bool ObjFileLoader::createMeshFromFile (Mesh& meshOut, const std::string& filePath)
+{
+	if ( ! loadBuffersFromFile(filePath) ) return false;
+
 	meshOut.faces.clear();
 	for ( const FaceIndices& faceIndices : m_FaceBuffer )
 	{
@@ -103,6 +112,45 @@ bool ObjFileLoader::createMeshFromFile (Mesh& meshOut, const std::string& filePa
 	return true;
 }
 
+bool ObjFileLoader::createIndexedMeshFromFile (IndexedMesh& meshOut, const std::string& filePath)
+{
+	if ( ! loadBuffersFromFile(filePath) ) return false;
+
+	meshOut.vertices.clear();
+	meshOut.indices.clear();
+
+	// maps vertex, tex coord and normal indices to the index of the vertex in the mesh
+	std::map<std::array<unsigned int, 3>, unsigned int> vertexIndices;
+	auto addVertex = [&](unsigned int vertexIndex, unsigned int texCoordIndex, unsigned int normalIndex)
+		{
+			const std::array<unsigned int, 3> key = { vertexIndex, texCoordIndex, normalIndex };
+			auto vertexIndexIt = vertexIndices.find( key );
+			if ( vertexIndexIt == vertexIndices.end() )
+			{
+				vertexIndexIt = vertexIndices.emplace( key, meshOut.vertices.size() ).first;
+				meshOut.vertices.push_back(
+					Vertex
+					{
+						m_VertexBuffer[vertexIndex - 1],
+						m_NormalBuffer[normalIndex - 1],
+						m_TexCoordBuffer[texCoordIndex - 1]
+					}
+				);
+			}
+
+			meshOut.indices.push_back( vertexIndexIt->second );
+		};
+
+	for ( const FaceIndices& faceIndices : m_FaceBuffer )
+	{
+		addVertex( faceIndices.vertexIndex1, faceIndices.texCoordIndex1, faceIndices.normalIndex1 );
+		addVertex( faceIndices.vertexIndex2, faceIndices.texCoordIndex2, faceIndices.normalIndex2 );
+		addVertex( faceIndices.vertexIndex3, faceIndices.texCoordIndex3, faceIndices.normalIndex3 );
+	}
+
+	return true;
+}
+
 size_t splitStrBySpaces (const std::string& string, std::vector<std::string>& strings, char delimiter)
 {
 	size_t pos = string.find( delimiter );
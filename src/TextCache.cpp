@@ -0,0 +1,166 @@
+#include "TextCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+
+TextCache::TextCache (unsigned int maxBytes, bool keepMasks) :
+	m_MaxBytes( maxBytes ),
+	m_KeepMasks( keepMasks ),
+	m_SizeInBytes( 0 ),
+	m_Entries(),
+	m_EntriesByHash(),
+	m_UncachedText()
+{
+}
+
+const RenderedText& TextCache::getText (const Font& font, const char* text, unsigned int scaleFactor)
+{
+	const std::size_t hash = getHash( font, text, scaleFactor );
+	const auto matchingEntries = m_EntriesByHash.equal_range( hash );
+	for ( auto entryIt = matchingEntries.first; entryIt != matchingEntries.second; entryIt++ )
+	{
+		const std::list<TextCacheEntry>::iterator entry = entryIt->second;
+		if ( entry->font == &font && entry->scaleFactor == scaleFactor && entry->text == text )
+		{
+			// moving the entry to the front doesn't invalidate any iterators
+			m_Entries.splice( m_Entries.begin(), m_Entries, entry );
+			return entry->renderedText;
+		}
+	}
+
+	TextCacheEntry newEntry{ &font, text, scaleFactor, hash, RenderedText(), 0 };
+	renderText( font, text, scaleFactor, m_KeepMasks, newEntry.renderedText );
+	const unsigned int entrySize = getSizeInBytes( newEntry );
+	newEntry.sizeInBytes = entrySize;
+	if ( entrySize > m_MaxBytes )
+	{
+		m_UncachedText = std::move( newEntry.renderedText );
+		return m_UncachedText;
+	}
+
+	while ( m_SizeInBytes + entrySize > m_MaxBytes )
+	{
+		this->evictLeastRecentlyUsed();
+	}
+
+	m_Entries.push_front( std::move(newEntry) );
+	m_EntriesByHash.emplace( hash, m_Entries.begin() );
+	m_SizeInBytes += entrySize;
+
+	return m_Entries.front().renderedText;
+}
+
+void TextCache::clear()
+{
+	m_Entries.clear();
+	m_EntriesByHash.clear();
+	m_SizeInBytes = 0;
+}
+
+std::size_t TextCache::getHash (const Font& font, const char* text, unsigned int scaleFactor)
+{
+	// FNV-1a, so that looking up text doesn't copy it into a key
+	std::size_t hash = std::hash<const Font*>()( &font ) ^ ( static_cast<std::size_t>(scaleFactor) << 16 );
+	for ( const char* character = text; *character != '\0'; character++ )
+	{
+		hash = ( hash ^ static_cast<uint8_t>(*character) ) * 1099511628211ull;
+	}
+
+	return hash;
+}
+
+unsigned int TextCache::getSizeInBytes (const TextCacheEntry& entry)
+{
+	// roughly what the entry allocates, including the nodes of the list and the map
+	return sizeof( TextCacheEntry ) + ( sizeof(void*) * 4 ) + entry.text.capacity()
+		+ ( entry.renderedText.spans.capacity() * sizeof(TextSpan) ) + entry.renderedText.masks.capacity();
+}
+
+void TextCache::renderText (const Font& font, const char* text, unsigned int scaleFactor, bool keepMasks,
+				RenderedText& renderedTextOut)
+{
+	constexpr unsigned int maxPixels = UINT16_MAX;
+	const unsigned int characterWidth = font.getCharacterWidth() * scaleFactor;
+	const unsigned int numCharacters = std::min<std::size_t>( std::strlen(text), maxPixels / std::max(characterWidth, 1u) );
+	renderedTextOut.width = numCharacters * characterWidth;
+	renderedTextOut.height = std::min( font.getBitmapHeight() * scaleFactor, maxPixels );
+
+	std::vector<TextSpan>& spans = renderedTextOut.spans;
+	spans.clear();
+	for ( unsigned int charIndex = 0; charIndex < numCharacters; charIndex++ )
+	{
+		unsigned int numRuns = 0;
+		const FontGlyphRun* runs = font.getGlyphRuns( text[charIndex], numRuns );
+		for ( unsigned int runNum = 0; runNum < numRuns; runNum++ )
+		{
+			const unsigned int xStart = ( charIndex * characterWidth ) + ( runs[runNum].xStart * scaleFactor );
+			for ( unsigned int rowNum = 0; rowNum < scaleFactor; rowNum++ )
+			{
+				const unsigned int row = ( runs[runNum].row * scaleFactor ) + rowNum;
+				if ( row < renderedTextOut.height )
+				{
+					spans.push_back( TextSpan{static_cast<uint16_t>(row), static_cast<uint16_t>(xStart),
+								static_cast<uint16_t>(runs[runNum].length * scaleFactor)} );
+				}
+			}
+		}
+	}
+
+	std::sort( spans.begin(), spans.end(), [](const TextSpan& span1, const TextSpan& span2)
+			{ return ( span1.row != span2.row ) ? span1.row < span2.row : span1.xStart < span2.xStart; } );
+
+	// runs that touch at the edges of two characters are joined into one span
+	unsigned int numSpans = 0;
+	for ( const TextSpan& span : spans )
+	{
+		if ( numSpans > 0 && spans[numSpans - 1].row == span.row && spans[numSpans - 1].xStart + spans[numSpans - 1].length == span.xStart )
+		{
+			spans[numSpans - 1].length += span.length;
+		}
+		else
+		{
+			spans[numSpans] = span;
+			numSpans++;
+		}
+	}
+	spans.resize( numSpans );
+
+	renderedTextOut.maskBytesPerRow = 0;
+	renderedTextOut.masks.clear();
+	if ( keepMasks )
+	{
+		const unsigned int bytesPerRow = ( renderedTextOut.width + 7 ) / 8;
+		renderedTextOut.maskBytesPerRow = bytesPerRow;
+		renderedTextOut.masks.assign( bytesPerRow * renderedTextOut.height, 0 );
+		for ( const TextSpan& span : spans )
+		{
+			uint8_t* rowMask = &renderedTextOut.masks[span.row * bytesPerRow];
+			const unsigned int xEnd = std::min<unsigned int>( span.xStart + span.length, renderedTextOut.width );
+			for ( unsigned int x = span.xStart; x < xEnd; x++ )
+			{
+				rowMask[x / 8] |= 0x80 >> ( x % 8 );
+			}
+		}
+		spans.clear();
+	}
+	spans.shrink_to_fit();
+}
+
+void TextCache::evictLeastRecentlyUsed()
+{
+	const std::list<TextCacheEntry>::iterator entry = std::prev( m_Entries.end() );
+	const auto matchingEntries = m_EntriesByHash.equal_range( entry->hash );
+	for ( auto entryIt = matchingEntries.first; entryIt != matchingEntries.second; entryIt++ )
+	{
+		if ( entryIt->second == entry )
+		{
+			m_EntriesByHash.erase( entryIt );
+			break;
+		}
+	}
+
+	m_SizeInBytes -= entry->sizeInBytes;
+	m_Entries.erase( entry );
+}